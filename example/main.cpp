@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include <array>
 #include <vec/vec.hpp>
@@ -45,6 +46,13 @@ int main(int argc, char** argv)
         field_2[i] = 10.0 * drand48();
     }
 
+    for (auto& v : field_1)
+    {
+        v = 10.0 * drand48();
+    }
+
+    std::sort(field_1.begin(), field_1.end(), [] (const vec_t& a, const vec_t& b) { return a.length() < b.length(); });
+
     #pragma omp simd
     for (std::size_t i = 0; i < n; ++i)
     {
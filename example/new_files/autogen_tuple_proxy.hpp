@@ -72,6 +72,29 @@ namespace TUPLE_NAMESPACE
 
     public:
 
+        tuple_proxy& operator=(const tuple_proxy& rhs)
+        {
+            x = rhs.x;
+            y = rhs.y;
+            z = rhs.z;
+            return *this;
+        }
+
+        tuple_proxy& operator=(const original_type& rhs)
+        {
+            x = rhs.x;
+            y = rhs.y;
+            z = rhs.z;
+            return *this;
+        }
+
+        friend void swap(tuple_proxy a, tuple_proxy b)
+        {
+            const original_type tmp(a);
+            a = b;
+            b = tmp;
+        }
+
         T_1& x;
         T_2& y;
         T_3& z;
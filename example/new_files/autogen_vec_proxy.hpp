@@ -66,6 +66,29 @@ namespace VEC_NAMESPACE
 
     public:
 
+        vec_proxy& operator=(const vec_proxy& rhs)
+        {
+            x = rhs.x;
+            y = rhs.y;
+            z = rhs.z;
+            return *this;
+        }
+
+        vec_proxy& operator=(const original_type& rhs)
+        {
+            x = rhs.x;
+            y = rhs.y;
+            z = rhs.z;
+            return *this;
+        }
+
+        friend void swap(vec_proxy a, vec_proxy b)
+        {
+            const original_type tmp(a);
+            a = b;
+            b = tmp;
+        }
+
         //! Remember the template type parameter T
         using value_type = T;
         //! Remember the template parameter D (=3)
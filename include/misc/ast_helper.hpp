@@ -7,6 +7,7 @@
 #define MISC_AST_HELPER_HPP
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <clang/AST/AST.h>
@@ -194,6 +195,38 @@ namespace TRAFO_NAMESPACE
             return dumpSourceRangeToString(sourceRange, sourceManager, clang::LangOptions());
         }
         
+        static const clang::Stmt* getParentIgnoringImplicitCode(const clang::Stmt& stmt, clang::ASTContext& context)
+        {
+            auto parents = context.getParents(stmt);
+
+            while (!parents.empty())
+            {
+                const clang::Stmt* const parent = parents[0].get<clang::Stmt>();
+
+                if (!parent) return nullptr;
+
+                if (llvm::isa<clang::ImplicitCastExpr>(parent) || llvm::isa<clang::ParenExpr>(parent) || llvm::isa<clang::MaterializeTemporaryExpr>(parent))
+                {
+                    parents = context.getParents(*parent);
+                    continue;
+                }
+
+                return parent;
+            }
+
+            return nullptr;
+        }
+
+        // the end location of 'sourceRange' is the beginning of the last token (e.g. the source range of an expression)
+        static std::string dumpTokenRangeToString(const clang::SourceRange sourceRange, const clang::SourceManager& sourceManager)
+        {
+            if (!sourceRange.isValid()) return std::string("");
+
+            const llvm::StringRef sourceText = clang::Lexer::getSourceText(clang::CharSourceRange::getTokenRange(sourceRange), sourceManager, clang::LangOptions());
+
+            return sourceText.str();
+        }
+
         static std::string dumpContainingLineToString(const clang::SourceLocation& sourceLocation, clang::ASTContext& context)
         {
             const clang::SourceLocation beginOfLine = getBeginOfLine(sourceLocation, context);
@@ -273,6 +306,33 @@ namespace TRAFO_NAMESPACE
             return clang::SourceRange(withIndentation ? beginLocation : getBeginOfLine(beginLocation, context), colonLocation);
         }
 
+        static std::map<std::string, std::string> getAnnotations(const clang::Decl& decl, const std::string prefix = std::string("trafo:"))
+        {
+            // annotations have the form __attribute__((annotate("trafo:key=value"))) or [[clang::annotate("trafo:key")]]
+            std::map<std::string, std::string> annotations;
+
+            for (const clang::AnnotateAttr* const attr : decl.specific_attrs<clang::AnnotateAttr>())
+            {
+                const std::string annotation = removeSpaces(attr->getAnnotation().str());
+
+                if (annotation.find(prefix) != 0) continue;
+
+                const std::string keyValue = annotation.substr(prefix.length());
+                const std::size_t pos = keyValue.find('=');
+
+                if (pos == std::string::npos)
+                {
+                    annotations[keyValue] = std::string("");
+                }
+                else
+                {
+                    annotations[keyValue.substr(0, pos)] = keyValue.substr(pos + 1);
+                }
+            }
+
+            return annotations;
+        }
+
         static bool isThisAMacroExpansion(const clang::NamedDecl& decl)
         {
             clang::ASTContext& context = decl.getASTContext();
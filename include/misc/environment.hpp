@@ -0,0 +1,46 @@
+// Copyright (c) 2017-2019 Florian Wende (flwende@gmail.com)
+//
+// Distributed under the BSD 2-clause Software License
+// (See accompanying file LICENSE)
+
+#if !defined(MISC_ENVIRONMENT_HPP)
+#define MISC_ENVIRONMENT_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if !defined(TRAFO_NAMESPACE)
+    #define TRAFO_NAMESPACE fw
+#endif
+
+namespace TRAFO_NAMESPACE
+{
+    namespace internal
+    {
+        static std::string getEnvironmentVariable(const std::string& name, const std::string defaultValue = std::string(""))
+        {
+            if (const char* value = secure_getenv(name.c_str()))
+            {
+                return std::string(value);
+            }
+
+            return defaultValue;
+        }
+
+        static std::size_t getEnvironmentVariableAsInteger(const std::string& name, const std::size_t defaultValue = 0)
+        {
+            const std::string value = getEnvironmentVariable(name);
+
+            if (value == std::string("")) return defaultValue;
+
+            // invalid (non-numeric) values fall back to the default value
+            char* end = nullptr;
+            const std::size_t result = std::strtoul(value.c_str(), &end, 10);
+
+            return (end && *end == '\0' ? result : defaultValue);
+        }
+    }
+}
+
+#endif
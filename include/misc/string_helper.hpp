@@ -107,6 +107,14 @@ namespace TRAFO_NAMESPACE
             return output;
         }
 
+        static std::string trim(const std::string& input)
+        {
+            const std::size_t begin = input.find_first_not_of(std::string(" \t\n"));
+            const std::size_t end = input.find_last_not_of(std::string(" \t\n"));
+
+            return (begin != std::string::npos ? input.substr(begin, end - begin + 1) : std::string(""));
+        }
+
         static std::string concat(const std::vector<std::string>& input, const std::string delimiter = std::string(""))
         {
             std::string output;
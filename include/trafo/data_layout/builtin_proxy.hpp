@@ -0,0 +1,359 @@
+// Copyright (c) 2017-2019 Florian Wende (flwende@gmail.com)
+//
+// Distributed under the BSD 2-clause Software License
+// (See accompanying file LICENSE)
+
+#if !defined(TRAFO_DATA_LAYOUT_BUILTIN_PROXY_HPP)
+#define TRAFO_DATA_LAYOUT_BUILTIN_PROXY_HPP
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <misc/ast_helper.hpp>
+
+#if !defined(TRAFO_NAMESPACE)
+    #define TRAFO_NAMESPACE fw
+#endif
+
+namespace TRAFO_NAMESPACE
+{
+    namespace internal
+    {
+        // standard library element types have their definitions in system headers, which are not transformed:
+        // their proxy types are part of the generated header 'autogen_builtin_proxy.hpp'
+        static std::string getBuiltinProxyName(const clang::QualType& qualType)
+        {
+            const clang::CXXRecordDecl* const decl = (qualType.isNull() ? nullptr : qualType->getAsCXXRecordDecl());
+            if (!decl || !decl->isInStdNamespace()) return std::string("");
+
+            const std::string name = decl->getNameAsString();
+            if (name == std::string("complex")) return name;
+
+            // pairs and tuples: all members must be of fundamental type
+            if (name == std::string("pair") || name == std::string("tuple"))
+            {
+                const clang::ClassTemplateSpecializationDecl* const specialization = clang::dyn_cast<clang::ClassTemplateSpecializationDecl>(decl);
+                if (!specialization) return std::string("");
+
+                std::vector<clang::TemplateArgument> arguments;
+                for (const auto& argument : specialization->getTemplateArgs().asArray())
+                {
+                    if (argument.getKind() == clang::TemplateArgument::Pack)
+                    {
+                        for (const auto& packArgument : argument.pack_elements()) arguments.push_back(packArgument);
+                    }
+                    else
+                    {
+                        arguments.push_back(argument);
+                    }
+                }
+
+                if (arguments.size() == 0) return std::string("");
+
+                for (const auto& argument : arguments)
+                {
+                    if (argument.getKind() != clang::TemplateArgument::Type) return std::string("");
+                    if (!argument.getAsType()->isFundamentalType() || argument.getAsType()->isVoidType()) return std::string("");
+                }
+
+                return name;
+            }
+
+            return std::string("");
+        }
+
+        // non-member functions of 'std::complex' that 'complex_proxy' provides overloads for
+        static const std::vector<std::string>& getComplexProxyFunctionNames()
+        {
+            static const std::vector<std::string> functionNames = {"real", "imag", "abs", "arg", "norm", "conj", "proj", "exp", "log", "log10", "sqrt", "sin", "cos", "tan", "sinh", "cosh", "tanh"};
+
+            return functionNames;
+        }
+
+        static std::string generateBuiltinFriendDeclarations(const std::string indent)
+        {
+            std::stringstream friends;
+
+            friends << indent << "template <typename _X, std::size_t _N, std::size_t _D, XXX_NAMESPACE::data_layout _L>\n";
+            friends << indent << "friend class XXX_NAMESPACE::internal::accessor;\n\n";
+            friends << indent << "template <typename _P, typename _R>\n";
+            friends << indent << "friend class XXX_NAMESPACE::internal::iterator;\n\n";
+
+            return friends.str();
+        }
+
+        static std::string generateBuiltinComplexProxy(const std::string indent = std::string("        "))
+        {
+            const std::string extIndent = indent + std::string("    ");
+            const std::string extExtIndent = extIndent + std::string("    ");
+            const std::string scalar = std::string("typename std::remove_cv<T>::type");
+            const std::string complex = std::string("std::complex<typename std::remove_cv<T>::type>");
+            std::stringstream proxy;
+
+            // proxy class: real and imaginary parts are separate streams
+            proxy << indent << "template <typename T>\n";
+            proxy << indent << "class complex_proxy\n";
+            proxy << indent << "{\n";
+            proxy << generateBuiltinFriendDeclarations(extIndent);
+            proxy << extIndent << "template <typename _T>\n";
+            proxy << extIndent << "friend class complex_proxy;\n\n";
+            proxy << extIndent << "using T_unqualified = typename std::remove_cv<T>::type;\n\n";
+            proxy << extIndent << "T& re;\n";
+            proxy << extIndent << "T& im;\n\n";
+            proxy << indent << "public:\n\n";
+            proxy << extIndent << "using type = complex_proxy<T>;\n";
+            proxy << extIndent << "using const_type = complex_proxy<const T>;\n";
+            proxy << extIndent << "using base_pointer = XXX_NAMESPACE::multi_pointer_n<T, 2>;\n";
+            proxy << extIndent << "using value_type = std::complex<T_unqualified>;\n";
+            proxy << extIndent << "using original_type = typename std::conditional<std::is_const<T>::value, const value_type, value_type>::type;\n\n";
+            proxy << extIndent << "complex_proxy(base_pointer base)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "re(base.ptr[0 * base.n_0]),\n" << extExtIndent << "im(base.ptr[1 * base.n_0])\n" << extIndent << "{}\n\n";
+            proxy << extIndent << "complex_proxy(std::tuple<T&, T&> obj)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "re(std::get<0>(obj)),\n" << extExtIndent << "im(std::get<1>(obj))\n" << extIndent << "{}\n\n";
+            proxy << extIndent << "T_unqualified real() const { return re; }\n";
+            proxy << extIndent << "T_unqualified imag() const { return im; }\n";
+            proxy << extIndent << "void real(const T_unqualified value) { re = value; }\n";
+            proxy << extIndent << "void imag(const T_unqualified value) { im = value; }\n\n";
+            proxy << extIndent << "operator value_type() const { return value_type(re, im); }\n\n";
+            proxy << extIndent << "complex_proxy& operator=(const complex_proxy& z) { re = z.re; im = z.im; return *this; }\n";
+            proxy << extIndent << "template <typename X>\n";
+            proxy << extIndent << "complex_proxy& operator=(const complex_proxy<X>& z) { re = z.re; im = z.im; return *this; }\n";
+            proxy << extIndent << "complex_proxy& operator=(const value_type& z) { re = z.real(); im = z.imag(); return *this; }\n";
+            proxy << extIndent << "complex_proxy& operator=(const T_unqualified x) { re = x; im = 0; return *this; }\n";
+            proxy << extIndent << "friend void swap(complex_proxy a, complex_proxy b) { const value_type tmp(a); a = b; b = tmp; }\n";
+            for (const std::string op : {"+", "-", "*", "/"})
+            {
+                proxy << extIndent << "complex_proxy& operator" << op << "=(const value_type& z) { return (*this = (value_type(re, im) " << op << " z)); }\n";
+                proxy << extIndent << "complex_proxy& operator" << op << "=(const T_unqualified x) { return (*this = (value_type(re, im) " << op << " x)); }\n";
+                proxy << extIndent << "template <typename X>\n";
+                proxy << extIndent << "complex_proxy& operator" << op << "=(const complex_proxy<X>& z) { return (*this = (value_type(re, im) " << op << " value_type(z.re, z.im))); }\n";
+            }
+            proxy << indent << "};\n\n";
+
+            // arithmetic and comparison: same semantics as the std::complex operators
+            for (const std::string op : {"+", "-", "*", "/", "==", "!="})
+            {
+                const std::string returnType = ((op == std::string("==") || op == std::string("!=")) ? std::string("bool") : complex);
+
+                proxy << indent << "template <typename T, typename X>\n";
+                proxy << indent << "inline " << returnType << " operator" << op << "(const complex_proxy<T>& a, const complex_proxy<X>& b) { return (" << complex << "(a) " << op << " " << complex << "(b.real(), b.imag())); }\n";
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "inline " << returnType << " operator" << op << "(const complex_proxy<T>& a, const " << complex << "& b) { return (" << complex << "(a) " << op << " b); }\n";
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "inline " << returnType << " operator" << op << "(const " << complex << "& a, const complex_proxy<T>& b) { return (a " << op << " " << complex << "(b)); }\n";
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "inline " << returnType << " operator" << op << "(const complex_proxy<T>& a, const " << scalar << "& b) { return (" << complex << "(a) " << op << " b); }\n";
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "inline " << returnType << " operator" << op << "(const " << scalar << "& a, const complex_proxy<T>& b) { return (a " << op << " " << complex << "(b)); }\n\n";
+            }
+
+            for (const std::string op : {"+", "-"})
+            {
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "inline " << complex << " operator" << op << "(const complex_proxy<T>& z) { return " << op << complex << "(z); }\n";
+            }
+            proxy << "\n";
+
+            // non-member functions: found through argument dependent lookup
+            for (const std::string& function : getComplexProxyFunctionNames())
+            {
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "inline auto " << function << "(const complex_proxy<T>& z) -> decltype(std::" << function << "(std::declval<" << complex << ">())) { return std::" << function << "(" << complex << "(z)); }\n";
+            }
+            proxy << "\n";
+
+            proxy << indent << "template <typename T>\n";
+            proxy << indent << "std::ostream& operator<<(std::ostream& os, const complex_proxy<T>& z) { return (os << " << complex << "(z)); }\n\n";
+
+            // type traits
+            for (const std::string qualifier : {"", "const "})
+            {
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "struct provides_proxy_type<" << qualifier << "std::complex<T>>\n";
+                proxy << indent << "{\n";
+                proxy << extIndent << "static constexpr bool value = true;\n";
+                proxy << indent << "};\n\n";
+                proxy << indent << "template <typename T>\n";
+                proxy << indent << "struct proxy_type_of<" << qualifier << "std::complex<T>>\n";
+                proxy << indent << "{\n";
+                proxy << extIndent << "using type = complex_proxy<" << qualifier << "T>;\n";
+                proxy << indent << "};\n\n";
+            }
+
+            return proxy.str();
+        }
+
+        static std::string generateBuiltinPairProxy(const std::string indent = std::string("        "))
+        {
+            const std::string extIndent = indent + std::string("    ");
+            const std::string extExtIndent = extIndent + std::string("    ");
+            const std::string pair = std::string("std::pair<typename std::remove_cv<T1>::type, typename std::remove_cv<T2>::type>");
+            std::stringstream proxy;
+
+            // proxy class: derives from a pair of references, so that 'first', 'second' and std::get<I> work as usual
+            proxy << indent << "template <typename T1, typename T2>\n";
+            proxy << indent << "class pair_proxy : public std::pair<T1&, T2&>\n";
+            proxy << indent << "{\n";
+            proxy << generateBuiltinFriendDeclarations(extIndent);
+            proxy << extIndent << "using base_type = std::pair<T1&, T2&>;\n\n";
+            proxy << indent << "public:\n\n";
+            proxy << extIndent << "using type = pair_proxy<T1, T2>;\n";
+            proxy << extIndent << "using const_type = pair_proxy<const T1, const T2>;\n";
+            proxy << extIndent << "using base_pointer = XXX_NAMESPACE::multi_pointer_inhomogeneous<T1, T2>;\n";
+            proxy << extIndent << "using value_type = " << pair << ";\n";
+            proxy << extIndent << "using original_type = typename std::conditional<std::is_const<T1>::value, const value_type, value_type>::type;\n\n";
+            proxy << extIndent << "pair_proxy(base_pointer base)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "base_type(*(std::get<0>(base.ptr)), *(std::get<1>(base.ptr)))\n" << extIndent << "{}\n\n";
+            proxy << extIndent << "pair_proxy(std::tuple<T1&, T2&> obj)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "base_type(std::get<0>(obj), std::get<1>(obj))\n" << extIndent << "{}\n\n";
+            proxy << extIndent << "operator value_type() const { return value_type(this->first, this->second); }\n\n";
+            proxy << extIndent << "pair_proxy& operator=(const pair_proxy& p) { this->first = p.first; this->second = p.second; return *this; }\n";
+            proxy << extIndent << "template <typename X1, typename X2>\n";
+            proxy << extIndent << "pair_proxy& operator=(const pair_proxy<X1, X2>& p) { this->first = p.first; this->second = p.second; return *this; }\n";
+            proxy << extIndent << "pair_proxy& operator=(const value_type& p) { this->first = p.first; this->second = p.second; return *this; }\n";
+            proxy << extIndent << "friend void swap(pair_proxy a, pair_proxy b) { const value_type tmp(a); a = b; b = tmp; }\n";
+            proxy << indent << "};\n\n";
+
+            // comparison with std::pair: the std::pair operators cannot deduce their arguments from mixed operands
+            for (const std::string op : {"==", "!=", "<", ">", "<=", ">="})
+            {
+                proxy << indent << "template <typename T1, typename T2>\n";
+                proxy << indent << "inline bool operator" << op << "(const pair_proxy<T1, T2>& a, const " << pair << "& b) { return (" << pair << "(a) " << op << " b); }\n";
+                proxy << indent << "template <typename T1, typename T2>\n";
+                proxy << indent << "inline bool operator" << op << "(const " << pair << "& a, const pair_proxy<T1, T2>& b) { return (a " << op << " " << pair << "(b)); }\n";
+            }
+            proxy << "\n";
+
+            // type traits
+            for (const std::string qualifier : {"", "const "})
+            {
+                proxy << indent << "template <typename T1, typename T2>\n";
+                proxy << indent << "struct provides_proxy_type<" << qualifier << "std::pair<T1, T2>>\n";
+                proxy << indent << "{\n";
+                proxy << extIndent << "static constexpr bool value = true;\n";
+                proxy << indent << "};\n\n";
+                proxy << indent << "template <typename T1, typename T2>\n";
+                proxy << indent << "struct proxy_type_of<" << qualifier << "std::pair<T1, T2>>\n";
+                proxy << indent << "{\n";
+                proxy << extIndent << "using type = pair_proxy<" << qualifier << "T1, " << qualifier << "T2>;\n";
+                proxy << indent << "};\n\n";
+            }
+
+            return proxy.str();
+        }
+
+        static std::string generateBuiltinTupleProxy(const std::string indent = std::string("        "))
+        {
+            const std::string extIndent = indent + std::string("    ");
+            const std::string extExtIndent = extIndent + std::string("    ");
+            const std::string tuple = std::string("std::tuple<typename std::remove_cv<T>::type...>");
+            std::stringstream proxy;
+
+            // index lists for the construction from the base pointer (C++11 has no std::index_sequence)
+            proxy << indent << "template <std::size_t... I>\n";
+            proxy << indent << "struct tuple_proxy_indices {};\n\n";
+            proxy << indent << "template <std::size_t N, std::size_t... I>\n";
+            proxy << indent << "struct make_tuple_proxy_indices : make_tuple_proxy_indices<N - 1, N - 1, I...> {};\n\n";
+            proxy << indent << "template <std::size_t... I>\n";
+            proxy << indent << "struct make_tuple_proxy_indices<0, I...>\n";
+            proxy << indent << "{\n";
+            proxy << extIndent << "using type = tuple_proxy_indices<I...>;\n";
+            proxy << indent << "};\n\n";
+
+            // proxy class: derives from a tuple of references, so that std::get<I> and std::tie work as usual
+            proxy << indent << "template <typename... T>\n";
+            proxy << indent << "class tuple_proxy : public std::tuple<T&...>\n";
+            proxy << indent << "{\n";
+            proxy << generateBuiltinFriendDeclarations(extIndent);
+            proxy << extIndent << "using base_type = std::tuple<T&...>;\n\n";
+            proxy << extIndent << "template <typename P, std::size_t... I>\n";
+            proxy << extIndent << "tuple_proxy(P& base, tuple_proxy_indices<I...>)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "base_type(*(std::get<I>(base.ptr))...)\n" << extIndent << "{}\n\n";
+            proxy << indent << "public:\n\n";
+            proxy << extIndent << "using type = tuple_proxy<T...>;\n";
+            proxy << extIndent << "using const_type = tuple_proxy<const T...>;\n";
+            proxy << extIndent << "using base_pointer = XXX_NAMESPACE::multi_pointer_inhomogeneous<T...>;\n";
+            proxy << extIndent << "using value_type = " << tuple << ";\n";
+            proxy << extIndent << "using original_type = typename std::conditional<std::is_const<typename std::tuple_element<0, std::tuple<T...>>::type>::value, const value_type, value_type>::type;\n\n";
+            proxy << extIndent << "tuple_proxy(base_pointer base)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "tuple_proxy(base, typename make_tuple_proxy_indices<sizeof...(T)>::type())\n" << extIndent << "{}\n\n";
+            proxy << extIndent << "tuple_proxy(std::tuple<T&...> obj)\n" << extExtIndent << ":\n";
+            proxy << extExtIndent << "base_type(obj)\n" << extIndent << "{}\n\n";
+            proxy << extIndent << "operator value_type() const { return value_type(static_cast<const base_type&>(*this)); }\n\n";
+            proxy << extIndent << "tuple_proxy& operator=(const tuple_proxy& t) { base_type::operator=(static_cast<const base_type&>(t)); return *this; }\n";
+            proxy << extIndent << "template <typename... X>\n";
+            proxy << extIndent << "tuple_proxy& operator=(const tuple_proxy<X...>& t) { base_type::operator=(static_cast<const std::tuple<X&...>&>(t)); return *this; }\n";
+            proxy << extIndent << "tuple_proxy& operator=(const value_type& t) { base_type::operator=(t); return *this; }\n";
+            proxy << extIndent << "friend void swap(tuple_proxy a, tuple_proxy b) { const value_type tmp(a); a = b; b = tmp; }\n";
+            proxy << indent << "};\n\n";
+
+            // comparison with std::tuple: the std::tuple operators cannot deduce their arguments from mixed operands
+            for (const std::string op : {"==", "!=", "<", ">", "<=", ">="})
+            {
+                proxy << indent << "template <typename... T>\n";
+                proxy << indent << "inline bool operator" << op << "(const tuple_proxy<T...>& a, const " << tuple << "& b) { return (" << tuple << "(a) " << op << " b); }\n";
+                proxy << indent << "template <typename... T>\n";
+                proxy << indent << "inline bool operator" << op << "(const " << tuple << "& a, const tuple_proxy<T...>& b) { return (a " << op << " " << tuple << "(b)); }\n";
+            }
+            proxy << "\n";
+
+            // type traits
+            for (const std::string qualifier : {"", "const "})
+            {
+                proxy << indent << "template <typename... T>\n";
+                proxy << indent << "struct provides_proxy_type<" << qualifier << "std::tuple<T...>>\n";
+                proxy << indent << "{\n";
+                proxy << extIndent << "static constexpr bool value = true;\n";
+                proxy << indent << "};\n\n";
+                proxy << indent << "template <typename... T>\n";
+                proxy << indent << "struct proxy_type_of<" << qualifier << "std::tuple<T...>>\n";
+                proxy << indent << "{\n";
+                proxy << extIndent << "using type = tuple_proxy<" << qualifier << "T...>;\n";
+                proxy << indent << "};\n\n";
+            }
+
+            return proxy.str();
+        }
+
+        // all built-in proxy types go into one header: translation units that are processed later must not drop any of them
+        static std::string generateBuiltinProxyHeader()
+        {
+            const std::string indent = std::string("    ");
+            const std::string extIndent = indent + std::string("    ");
+            std::stringstream header;
+
+            header << "// my header\n\n";
+            header << "#if !defined(AUTOGEN_BUILTIN_PROXY_HPP)\n";
+            header << "#define AUTOGEN_BUILTIN_PROXY_HPP\n\n";
+            header << "#include <complex>\n";
+            header << "#include <ostream>\n";
+            header << "#include <tuple>\n";
+            header << "#include <type_traits>\n";
+            header << "#include <utility>\n\n";
+            header << "#include <common/memory.hpp>\n";
+            header << "#include <common/data_layout.hpp>\n";
+            header << "#include <common/traits.hpp>\n\n";
+            header << "namespace XXX_NAMESPACE\n{\n";
+            header << indent << "namespace internal\n";
+            header << indent << "{\n";
+            header << extIndent << "template <typename P, typename R>\n";
+            header << extIndent << "class iterator;\n\n";
+            header << extIndent << "template <typename X, std::size_t N, std::size_t D, XXX_NAMESPACE::data_layout L>\n";
+            header << extIndent << "class accessor;\n\n";
+            // 'provides_proxy_type' and 'proxy_type_of' (primary template: 'T::proxy_type') are declared in common/traits.hpp,
+            // which the buffer uses to look up the proxy type: the standard library types only add specializations
+            header << generateBuiltinComplexProxy(extIndent);
+            header << generateBuiltinPairProxy(extIndent);
+            header << generateBuiltinTupleProxy(extIndent);
+            header << indent << "}\n";
+            header << "}\n\n";
+            header << "#endif\n";
+
+            return header.str();
+        }
+    }
+}
+
+#endif
@@ -202,6 +202,89 @@ namespace TRAFO_NAMESPACE
 
             class Field
             {
+                // element type and extent of fixed-size array fields ('T x[N]' or 'std::array<T, N> x'): extent is 0 for any other field
+                static std::size_t getFixedSizeArrayExtent(const clang::FieldDecl& decl, std::string* elementTypeName = nullptr)
+                {
+                    clang::ASTContext& context = decl.getASTContext();
+                    const clang::QualType qualType = decl.getType();
+                    clang::QualType elementType;
+                    std::size_t extent = 0;
+
+                    if (const clang::ConstantArrayType* const arrayType = context.getAsConstantArrayType(qualType))
+                    {
+                        elementType = arrayType->getElementType();
+                        extent = arrayType->getSize().getZExtValue();
+                    }
+                    else if (const clang::CXXRecordDecl* const recordDecl = qualType->getAsCXXRecordDecl())
+                    {
+                        const clang::ClassTemplateSpecializationDecl* const specialization = llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(recordDecl);
+
+                        if (specialization && recordDecl->isInStdNamespace() && recordDecl->getNameAsString() == std::string("array"))
+                        {
+                            elementType = specialization->getTemplateArgs()[0].getAsType();
+                            extent = specialization->getTemplateArgs()[1].getAsIntegral().getZExtValue();
+                        }
+                    }
+                    else if (const clang::TemplateSpecializationType* const templateType = qualType->getAs<clang::TemplateSpecializationType>())
+                    {
+                        // std::array within a class template: the extent must not depend on template parameters
+                        const clang::TemplateDecl* const templateDecl = templateType->getTemplateName().getAsTemplateDecl();
+
+                        if (templateDecl && templateDecl->isInStdNamespace() && templateDecl->getNameAsString() == std::string("array") && templateType->getNumArgs() == 2)
+                        {
+                            const clang::TemplateArgument& extentArgument = templateType->getArg(1);
+                            llvm::APSInt value;
+
+                            if (extentArgument.getKind() == clang::TemplateArgument::ArgKind::Expression && extentArgument.getAsExpr()->isIntegerConstantExpr(value, context))
+                            {
+                                elementType = templateType->getArg(0).getAsType();
+                                extent = value.getZExtValue();
+                            }
+                        }
+                    }
+
+                    // only arrays of fundamental types or template type parameters
+                    const clang::Type* const type = elementType.getTypePtrOrNull();
+                    if (!type || !(type->isFundamentalType() || type->isTemplateTypeParmType())) return 0;
+
+                    if (elementTypeName)
+                    {
+                        *elementTypeName = elementType.getUnqualifiedType().getAsString();
+                    }
+
+                    return extent;
+                }
+
+                static std::string getFixedSizeArrayElementTypeName(const clang::FieldDecl& decl)
+                {
+                    std::string elementTypeName;
+
+                    return (getFixedSizeArrayExtent(decl, &elementTypeName) > 0 ? elementTypeName : std::string(""));
+                }
+
+                // name of the record type (or class template) of a field with record type, otherwise an empty string
+                static std::string getNestedRecordName(const clang::QualType& qualType)
+                {
+                    const clang::Type* const type = qualType.getTypePtrOrNull();
+                    if (!type) return std::string("");
+
+                    if (const clang::CXXRecordDecl* const recordDecl = type->getAsCXXRecordDecl())
+                    {
+                        return recordDecl->getNameAsString();
+                    }
+                    
+                    // template specialization that depends on template parameters of the enclosing class
+                    if (const clang::TemplateSpecializationType* const templateType = type->getAs<clang::TemplateSpecializationType>())
+                    {
+                        if (const clang::TemplateDecl* const templateDecl = templateType->getTemplateName().getAsTemplateDecl())
+                        {
+                            return templateDecl->getNameAsString();
+                        }
+                    }
+
+                    return std::string("");
+                }
+
             public:
                             
                 const clang::FieldDecl& decl;
@@ -217,6 +300,13 @@ namespace TRAFO_NAMESPACE
                 const bool isConst;
                 const bool isTemplateTypeParmType;
                 const bool isFundamentalOrTemplated;
+                const bool isEnum;
+                const std::size_t arrayExtent;
+                const std::string arrayElementTypeName;
+                const bool isArray;
+                const bool isStdArray;
+                const std::string nestedRecordName;
+                const bool isNestedRecord;
                 
                 Field(const clang::FieldDecl& decl, const AccessSpecifier::Kind access)
                     :
@@ -232,7 +322,14 @@ namespace TRAFO_NAMESPACE
                     isPrivate(access == AccessSpecifier::Kind::Private),
                     isConst(decl.getType().isConstQualified()),
                     isTemplateTypeParmType(type ? type->isTemplateTypeParmType() : false),
-                    isFundamentalOrTemplated(type ? (type->isFundamentalType() || isTemplateTypeParmType) : false)
+                    isFundamentalOrTemplated(type ? (type->isFundamentalType() || isTemplateTypeParmType) : false),
+                    isEnum(type ? type->isEnumeralType() : false),
+                    arrayExtent(getFixedSizeArrayExtent(decl)),
+                    arrayElementTypeName(getFixedSizeArrayElementTypeName(decl)),
+                    isArray(arrayExtent > 0),
+                    isStdArray(isArray && !(type && type->isArrayType())),
+                    nestedRecordName((isFundamentalOrTemplated || isEnum || isArray) ? std::string("") : getNestedRecordName(decl.getType())),
+                    isNestedRecord(nestedRecordName != std::string(""))
                 { ; }
 
                 void printInfo(const clang::SourceManager& sourceManager, const std::string indent = std::string("")) const
@@ -240,7 +337,15 @@ namespace TRAFO_NAMESPACE
                     std::cout << indent << "* name=" << name << ", type=" << typeName << (isConst ? " (const qualified)" : "") << std::endl;
                     std::cout << indent << "\t+-> range: " << sourceRange.printToString(sourceManager) << std::endl;
                     std::cout << indent << "\t+-> access: " << (isPublic ? "public" : (isProtected ? "protected" : "private")) << std::endl;
-                    std::cout << indent << "\t+-> fundamental or templated: " << (isFundamentalOrTemplated ? "yes" : "no") << std::endl;
+                    std::cout << indent << "\t+-> fundamental or templated: " << (isFundamentalOrTemplated ? "yes" : "no") << (isEnum ? " (enum)" : "") << std::endl;
+                    if (isArray)
+                    {
+                        std::cout << indent << "\t+-> fixed-size array: " << arrayElementTypeName << "[" << arrayExtent << "]" << std::endl;
+                    }
+                    if (isNestedRecord)
+                    {
+                        std::cout << indent << "\t+-> nested record: " << nestedRecordName << " (" << typeName << ")" << std::endl;
+                    }
                 }
             };
 
@@ -910,10 +1015,11 @@ namespace TRAFO_NAMESPACE
                     // at least one public field
                     isProxyClassCandidate &= (indexPublicFields.size() > 0);
 
-                    // public fields should be of fundamental or templated type
-                    for (const auto field : fields)
+                    // public fields should be of fundamental, enum or templated type, fixed-size arrays thereof, or records that are flattened recursively
+                    // note: whether the nested records are proxy class candidates themselves is checked by the proxy generator
+                    for (const auto& field : fields)
                     {
-                        hasNonFundamentalFields |= !(field.isFundamentalOrTemplated);
+                        hasNonFundamentalFields |= !(field.isFundamentalOrTemplated || field.isEnum || field.isArray || field.isNestedRecord);
                     }
 
                     isProxyClassCandidate &= !hasNonFundamentalFields;
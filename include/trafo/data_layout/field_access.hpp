@@ -0,0 +1,546 @@
+// Copyright (c) 2017-2019 Florian Wende (flwende@gmail.com)
+//
+// Distributed under the BSD 2-clause Software License
+// (See accompanying file LICENSE)
+
+#if !defined(TRAFO_DATA_LAYOUT_FIELD_ACCESS_HPP)
+#define TRAFO_DATA_LAYOUT_FIELD_ACCESS_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <clang/AST/DeclFriend.h>
+
+#include <misc/ast_helper.hpp>
+#include <misc/matcher.hpp>
+#include <trafo/data_layout/variable_declaration.hpp>
+
+#if !defined(TRAFO_NAMESPACE)
+    #define TRAFO_NAMESPACE fw
+#endif
+
+namespace TRAFO_NAMESPACE
+{
+    namespace internal
+    {
+        class FieldAccessAnalysis
+        {
+            // element data type name -> field name -> loops the field is accessed in
+            std::map<std::string, std::map<std::string, std::set<std::uint32_t>>> fieldAccesses;
+            // element data type name (or name of a nested record) -> fields that are read anywhere (not only within loops)
+            std::map<std::string, std::set<std::string>> fieldReads;
+            std::map<const clang::Stmt*, std::uint32_t> loopIds;
+            // assignments 'element.field = value;' that write a field without reading it
+            std::vector<std::pair<const clang::FieldDecl*, const clang::Expr*>> fieldWrites;
+            // the element types are shared by all translation units: the accesses of all of them (see 'addToProgram') determine the layouts
+            static std::map<std::string, std::map<std::string, std::set<std::uint32_t>>> programFieldAccesses;
+            static std::map<std::string, std::set<std::string>> programFieldReads;
+            static std::uint32_t numProgramLoops;
+            static bool isProgramComplete;
+            // references to the transformed declarations that are covered by element accesses
+            std::set<const clang::Expr*> elementAccessRoots;
+            clang::ASTContext& context;
+
+            // variables are referenced through DeclRefExprs, data members through MemberExprs
+            static const clang::ValueDecl* getReferencedDeclaration(const clang::Expr* expr)
+            {
+                if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast_or_null<clang::DeclRefExpr>(expr))
+                {
+                    return declRefExpr->getDecl();
+                }
+                else if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast_or_null<clang::MemberExpr>(expr))
+                {
+                    return llvm::dyn_cast<clang::FieldDecl>(memberExpr->getMemberDecl());
+                }
+
+                return nullptr;
+            }
+
+            static const clang::Expr* getAccessedDeclaration(const clang::Expr* expr, std::uint32_t& numSubscripts)
+            {
+                numSubscripts = 0;
+
+                while (expr)
+                {
+                    expr = expr->IgnoreParenImpCasts();
+
+                    if (const clang::ArraySubscriptExpr* const subscriptExpr = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr))
+                    {
+                        ++numSubscripts;
+                        expr = subscriptExpr->getBase();
+                    }
+                    else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(expr))
+                    {
+                        if (operatorCallExpr->getOperator() != clang::OO_Subscript) return nullptr;
+
+                        ++numSubscripts;
+                        expr = operatorCallExpr->getArg(0);
+                    }
+                    else if (getReferencedDeclaration(expr))
+                    {
+                        return expr;
+                    }
+                    else
+                    {
+                        return nullptr;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            const clang::Stmt* getParentIgnoringImplicitCode(const clang::Stmt& stmt) const
+            {
+                return TRAFO_NAMESPACE::internal::getParentIgnoringImplicitCode(stmt, context);
+            }
+
+            // 'stmt' names the field 'fieldName' of 'recordDecl' (of any object)
+            static bool refersToField(const clang::Stmt* const stmt, const clang::CXXRecordDecl& recordDecl, const std::string& fieldName)
+            {
+                if (!stmt) return false;
+
+                if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(stmt))
+                {
+                    const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(memberExpr->getMemberDecl());
+
+                    if (fieldDecl && fieldDecl->getParent() == &recordDecl && fieldDecl->getNameAsString() == fieldName) return true;
+                }
+
+                // members of class templates are referenced through dependent expressions
+                if (const clang::CXXDependentScopeMemberExpr* const memberExpr = llvm::dyn_cast<clang::CXXDependentScopeMemberExpr>(stmt))
+                {
+                    if (memberExpr->getMember().getAsString() == fieldName) return true;
+                }
+
+                for (const clang::Stmt* const child : stmt->children())
+                {
+                    if (refersToField(child, recordDecl, fieldName)) return true;
+                }
+
+                return false;
+            }
+
+            // returns false if 'this' is used other than for accessing fields, e.g. for calling other methods
+            static bool collectFieldsAccessedThroughThis(const clang::Stmt* const stmt, std::set<std::string>& fieldNames)
+            {
+                if (!stmt) return true;
+
+                if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(stmt))
+                {
+                    if (llvm::isa<clang::CXXThisExpr>(memberExpr->getBase()->IgnoreParenImpCasts()) && llvm::isa<clang::FieldDecl>(memberExpr->getMemberDecl()))
+                    {
+                        fieldNames.insert(memberExpr->getMemberDecl()->getNameAsString());
+                        return true;
+                    }
+                }
+
+                if (llvm::isa<clang::CXXThisExpr>(stmt)) return false;
+
+                bool onlyFieldAccesses = true;
+                for (const clang::Stmt* const child : stmt->children())
+                {
+                    onlyFieldAccesses &= collectFieldsAccessedThroughThis(child, fieldNames);
+                }
+
+                return onlyFieldAccesses;
+            }
+
+            // the assignment 'expr = value;' if it is a statement of its own: the value of any other assignment is used, which reads 'expr'
+            const clang::Expr* getAssignment(const clang::Expr& expr) const
+            {
+                const clang::Stmt* const parent = getParentIgnoringImplicitCode(expr);
+                const clang::Expr* assignment = nullptr;
+
+                if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast_or_null<clang::BinaryOperator>(parent))
+                {
+                    if (binaryOperator->getOpcode() == clang::BO_Assign && binaryOperator->getLHS()->IgnoreParenImpCasts() == &expr) assignment = binaryOperator;
+                }
+                else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast_or_null<clang::CXXOperatorCallExpr>(parent))
+                {
+                    if (operatorCallExpr->getOperator() == clang::OO_Equal && operatorCallExpr->getArg(0)->IgnoreParenImpCasts() == &expr) assignment = operatorCallExpr;
+                }
+
+                const clang::Stmt* const statement = (assignment ? getParentIgnoringImplicitCode(*assignment) : nullptr);
+
+                return (statement && llvm::isa<clang::CompoundStmt>(statement) ? assignment : nullptr);
+            }
+
+            bool isAssignmentTarget(const clang::Expr& expr) const
+            {
+                return (getAssignment(expr) != nullptr);
+            }
+
+            std::uint32_t getLoopId(const clang::Stmt* const loop)
+            {
+                const auto it = loopIds.find(loop);
+
+                if (it != loopIds.end()) return it->second;
+
+                const std::uint32_t loopId = loopIds.size();
+                loopIds[loop] = loopId;
+
+                return loopId;
+            }
+
+            void addFieldAccess(const std::string& recordName, const std::string& fieldName, const clang::Stmt* const loop, const bool isRead)
+            {
+                if (loop)
+                {
+                    fieldAccesses[recordName][fieldName].insert(getLoopId(loop));
+                }
+
+                if (isRead)
+                {
+                    fieldReads[recordName].insert(fieldName);
+                }
+            }
+
+            static const clang::CXXRecordDecl* getNestedRecordDecl(const clang::FieldDecl& field)
+            {
+                const clang::CXXRecordDecl* const recordDecl = field.getType()->getAsCXXRecordDecl();
+
+                // std::array fields are no nested records
+                return (recordDecl && recordDecl->hasDefinition() && !recordDecl->isInStdNamespace() ? recordDecl : nullptr);
+            }
+
+            // register all fields of 'recordDecl' and (recursively) of its nested records
+            void addAllFields(const clang::CXXRecordDecl& recordDecl, const clang::Stmt* const loop, const bool isRead)
+            {
+                for (const auto field : recordDecl.fields())
+                {
+                    addFieldAccess(recordDecl.getNameAsString(), field->getNameAsString(), loop, isRead);
+
+                    if (const clang::CXXRecordDecl* const nestedRecordDecl = getNestedRecordDecl(*field))
+                    {
+                        addAllFields(*nestedRecordDecl, loop, isRead);
+                    }
+                }
+            }
+
+            // register the fields of 'recordDecl' that are accessed through the expression 'recordExpr'
+            // note: 'loop' can be nullptr, in which case only field reads are registered
+            void addRecordAccess(const clang::Expr& recordExpr, const clang::CXXRecordDecl& recordDecl, const clang::Stmt* const loop)
+            {
+                const std::string recordName = recordDecl.getNameAsString();
+
+                if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast_or_null<clang::MemberExpr>(getParentIgnoringImplicitCode(recordExpr)))
+                {
+                    const clang::ValueDecl* const memberDecl = memberExpr->getMemberDecl();
+
+                    if (const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(memberDecl))
+                    {
+                        // record.field
+                        if (const clang::CXXRecordDecl* const nestedRecordDecl = getNestedRecordDecl(*fieldDecl))
+                        {
+                            // record.field.nested_field
+                            addFieldAccess(recordName, fieldDecl->getNameAsString(), loop, true);
+                            addRecordAccess(*memberExpr, *nestedRecordDecl, loop);
+                        }
+                        else if (const clang::Expr* const assignment = getAssignment(*memberExpr))
+                        {
+                            addFieldAccess(recordName, fieldDecl->getNameAsString(), loop, false);
+                            fieldWrites.emplace_back(fieldDecl, assignment);
+                        }
+                        else
+                        {
+                            addFieldAccess(recordName, fieldDecl->getNameAsString(), loop, true);
+                        }
+
+                        return;
+                    }
+                    
+                    if (const clang::CXXMethodDecl* const methodDecl = llvm::dyn_cast<clang::CXXMethodDecl>(memberDecl))
+                    {
+                        // record.method(..): all fields used within the method body
+                        std::set<std::string> fieldNames;
+                        if (methodDecl->hasBody() && collectFieldsAccessedThroughThis(methodDecl->getBody(), fieldNames))
+                        {
+                            for (const auto field : recordDecl.fields())
+                            {
+                                if (fieldNames.find(field->getNameAsString()) == fieldNames.end()) continue;
+
+                                addFieldAccess(recordName, field->getNameAsString(), loop, true);
+                                if (const clang::CXXRecordDecl* const nestedRecordDecl = getNestedRecordDecl(*field))
+                                {
+                                    addAllFields(*nestedRecordDecl, loop, true);
+                                }
+                            }
+
+                            return;
+                        }
+                    }
+                }
+
+                // the record is used as a whole, e.g. as a function argument or on either side of an assignment
+                addAllFields(recordDecl, loop, !isAssignmentTarget(recordExpr));
+            }
+
+            // register the fields of the element data type that are accessed through the element expression 'elementExpr'
+            void addElementAccess(const clang::Expr& elementExpr, const clang::Stmt* const loop, const Declaration& declaration)
+            {
+                const clang::CXXRecordDecl* const recordDecl = declaration.elementDataType->getAsCXXRecordDecl();
+                if (!recordDecl || !recordDecl->hasDefinition()) return;
+
+                addRecordAccess(elementExpr, *recordDecl, loop);
+            }
+
+            void addAllFieldsRead(const Declaration& declaration)
+            {
+                const clang::CXXRecordDecl* const recordDecl = declaration.elementDataType->getAsCXXRecordDecl();
+                if (!recordDecl || !recordDecl->hasDefinition()) return;
+
+                addAllFields(*recordDecl, nullptr, true);
+            }
+
+        public:
+
+            FieldAccessAnalysis(const std::vector<const Declaration*>& declarations, clang::ASTContext& context)
+                :
+                context(context)
+            {
+                using namespace clang::ast_matchers;
+
+                const auto loop = stmt(anyOf(forStmt(), cxxForRangeStmt(), whileStmt(), doStmt())).bind("loop");
+
+                // element accesses through subscript operators: the innermost enclosing loop (if any) is bound to "loop"
+                Matcher matcher;
+                matcher.addMatcher(expr(allOf(anyOf(arraySubscriptExpr(), cxxOperatorCallExpr(hasOverloadedOperatorName("[]"))), anyOf(hasAncestor(loop), anything()))).bind("elementAccess"),
+                    [&declarations, this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        const clang::Expr* const elementExpr = result.Nodes.getNodeAs<clang::Expr>("elementAccess");
+                        const clang::Stmt* const loopStmt = result.Nodes.getNodeAs<clang::Stmt>("loop");
+                        if (!elementExpr) return;
+
+                        std::uint32_t numSubscripts = 0;
+                        const clang::Expr* const declExpr = getAccessedDeclaration(elementExpr, numSubscripts);
+                        if (!declExpr) return;
+
+                        for (const auto& declaration : declarations)
+                        {
+                            // only full subscripts yield an element of the container
+                            if (&declaration->decl == getReferencedDeclaration(declExpr) && numSubscripts == (declaration->getNestingLevel() + 1))
+                            {
+                                elementAccessRoots.insert(declExpr);
+                                addElementAccess(*elementExpr, loopStmt, *declaration);
+                            }
+                        }
+                    });
+                matcher.run(context);
+
+                // range-based for loops over one-dimensional containers: the loop variable is the element
+                std::map<const clang::VarDecl*, std::pair<const clang::Stmt*, const Declaration*>> loopVariables;
+                Matcher loopMatcher;
+                loopMatcher.addMatcher(cxxForRangeStmt().bind("rangeLoop"),
+                    [&declarations, &loopVariables, this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::CXXForRangeStmt* const rangeLoop = result.Nodes.getNodeAs<clang::CXXForRangeStmt>("rangeLoop"))
+                        {
+                            const clang::Expr* const rangeInit = (rangeLoop->getRangeInit() ? rangeLoop->getRangeInit()->IgnoreParenImpCasts() : nullptr);
+                            if (!getReferencedDeclaration(rangeInit)) return;
+
+                            for (const auto& declaration : declarations)
+                            {
+                                if (&declaration->decl == getReferencedDeclaration(rangeInit) && declaration->getNestingLevel() == 0)
+                                {
+                                    elementAccessRoots.insert(rangeInit);
+                                    loopVariables[rangeLoop->getLoopVariable()] = std::make_pair(rangeLoop, declaration);
+                                }
+                            }
+                        }
+                    });
+                loopMatcher.run(context);
+
+                // any other use of a transformed declaration (e.g. passing it to a function) potentially reads all fields
+                Matcher declarationMatcher;
+                declarationMatcher.addMatcher(expr(anyOf(declRefExpr(), memberExpr())).bind("declaration"),
+                    [&declarations, this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::Expr* const declExpr = result.Nodes.getNodeAs<clang::Expr>("declaration"))
+                        {
+                            if (elementAccessRoots.find(declExpr) != elementAccessRoots.end()) return;
+
+                            for (const auto& declaration : declarations)
+                            {
+                                if (&declaration->decl == getReferencedDeclaration(declExpr))
+                                {
+                                    addAllFieldsRead(*declaration);
+                                }
+                            }
+                        }
+                    });
+                declarationMatcher.run(context);
+
+                if (loopVariables.empty()) return;
+
+                Matcher loopVariableMatcher;
+                loopVariableMatcher.addMatcher(declRefExpr().bind("loopVariable"),
+                    [&loopVariables, this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::DeclRefExpr* const declRefExpr = result.Nodes.getNodeAs<clang::DeclRefExpr>("loopVariable"))
+                        {
+                            const auto it = loopVariables.find(llvm::dyn_cast<clang::VarDecl>(declRefExpr->getDecl()));
+                            if (it == loopVariables.end()) return;
+
+                            addElementAccess(*declRefExpr, it->second.first, *(it->second.second));
+                        }
+                    });
+                loopVariableMatcher.run(context);
+            }
+
+            // merge the accesses of this translation unit into those of the program: loops of different translation units are different loops
+            void addToProgram() const
+            {
+                for (const auto& record : fieldAccesses)
+                {
+                    for (const auto& field : record.second)
+                    {
+                        for (const std::uint32_t loopId : field.second)
+                        {
+                            programFieldAccesses[record.first][field.first].insert(numProgramLoops + loopId);
+                        }
+                    }
+                }
+
+                for (const auto& record : fieldReads)
+                {
+                    programFieldReads[record.first].insert(record.second.begin(), record.second.end());
+                }
+
+                numProgramLoops += loopIds.size();
+            }
+
+            // all translation units have been analyzed: without their accesses, fields read in other translation units would be missed
+            static void setProgramComplete()
+            {
+                isProgramComplete = true;
+            }
+
+            static bool hasProgramFieldAccesses()
+            {
+                return isProgramComplete;
+            }
+
+            const std::vector<std::pair<const clang::FieldDecl*, const clang::Expr*>>& getFieldWrites() const
+            {
+                return fieldWrites;
+            }
+
+            // methods and friend functions of the element type are part of the proxy type: the fields they refer to (through 'this' or other objects) are kept
+            static bool isReferencedByMethods(const clang::CXXRecordDecl& recordDecl, const std::string& fieldName)
+            {
+                const clang::CXXRecordDecl* const pattern = recordDecl.getTemplateInstantiationPattern();
+                const clang::CXXRecordDecl& definition = (pattern ? *pattern : recordDecl);
+
+                for (const clang::Decl* const decl : definition.decls())
+                {
+                    const clang::FriendDecl* const friendDecl = llvm::dyn_cast<clang::FriendDecl>(decl);
+                    const clang::FunctionDecl* const function = (friendDecl ? (friendDecl->getFriendDecl() ? friendDecl->getFriendDecl()->getAsFunction() : nullptr) : decl->getAsFunction());
+                    if (!function || function->isImplicit()) continue;
+
+                    // other constructors are replaced in the proxy type, but the copy constructor is used for the conversion from the proxy type
+                    const clang::CXXConstructorDecl* const constructor = llvm::dyn_cast<clang::CXXConstructorDecl>(function);
+                    if (constructor && !constructor->isCopyConstructor()) continue;
+
+                    if (constructor)
+                    {
+                        for (const clang::CXXCtorInitializer* const initializer : constructor->inits())
+                        {
+                            if (initializer->isWritten() && refersToField(initializer->getInit(), definition, fieldName)) return true;
+                        }
+                    }
+
+                    if (function->hasBody() && refersToField(function->getBody(), definition, fieldName)) return true;
+                }
+
+                return false;
+            }
+
+            // group fields that are accessed within the same set of loops: fields that are not accessed within any loop form a cluster of their own
+            static std::vector<std::vector<std::string>> getFieldClusters(const std::string& elementDataTypeName, const std::vector<std::string>& fieldNames)
+            {
+                std::vector<std::pair<std::set<std::uint32_t>, std::vector<std::string>>> clusters;
+                const auto record = programFieldAccesses.find(elementDataTypeName);
+
+                for (const auto& fieldName : fieldNames)
+                {
+                    std::set<std::uint32_t> loops;
+                    if (record != programFieldAccesses.end())
+                    {
+                        const auto field = record->second.find(fieldName);
+                        if (field != record->second.end())
+                        {
+                            loops = field->second;
+                        }
+                    }
+
+                    bool isNewCluster = true;
+                    if (loops.size() > 0)
+                    {
+                        for (auto& cluster : clusters)
+                        {
+                            if (cluster.first == loops)
+                            {
+                                cluster.second.push_back(fieldName);
+                                isNewCluster = false;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (isNewCluster)
+                    {
+                        clusters.emplace_back(loops, std::vector<std::string>(1, fieldName));
+                    }
+                }
+
+                std::vector<std::vector<std::string>> fieldClusters;
+                for (const auto& cluster : clusters)
+                {
+                    fieldClusters.push_back(cluster.second);
+                }
+
+                return fieldClusters;
+            }
+
+            static bool isFieldRead(const std::string& elementDataTypeName, const std::string& fieldName)
+            {
+                const auto record = programFieldReads.find(elementDataTypeName);
+
+                return (record != programFieldReads.end() && record->second.find(fieldName) != record->second.end());
+            }
+
+            static void printInfo(const std::string indent = std::string(""))
+            {
+                std::cout << indent << "FIELD ACCESS (" << numProgramLoops << " loops)" << std::endl;
+                for (const auto& record : programFieldAccesses)
+                {
+                    std::cout << indent << "\t* " << record.first << std::endl;
+                    for (const auto& field : record.second)
+                    {
+                        std::cout << indent << "\t\t+-> " << field.first << ": accessed in " << field.second.size() << " loop(s)" << std::endl;
+                    }
+                }
+                for (const auto& record : programFieldReads)
+                {
+                    std::cout << indent << "\t* " << record.first << ", fields read:";
+                    for (const auto& fieldName : record.second)
+                    {
+                        std::cout << " " << fieldName;
+                    }
+                    std::cout << std::endl;
+                }
+            }
+        };
+
+        std::map<std::string, std::map<std::string, std::set<std::uint32_t>>> FieldAccessAnalysis::programFieldAccesses;
+        std::map<std::string, std::set<std::string>> FieldAccessAnalysis::programFieldReads;
+        std::uint32_t FieldAccessAnalysis::numProgramLoops = 0;
+        bool FieldAccessAnalysis::isProgramComplete = false;
+    }
+}
+
+#endif
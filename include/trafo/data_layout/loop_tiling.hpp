@@ -0,0 +1,566 @@
+// Copyright (c) 2017-2019 Florian Wende (flwende@gmail.com)
+//
+// Distributed under the BSD 2-clause Software License
+// (See accompanying file LICENSE)
+
+#if !defined(TRAFO_DATA_LAYOUT_LOOP_TILING_HPP)
+#define TRAFO_DATA_LAYOUT_LOOP_TILING_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <clang/Lex/Lexer.h>
+
+#include <misc/ast_helper.hpp>
+#include <misc/matcher.hpp>
+#include <misc/rewriter.hpp>
+
+#if !defined(TRAFO_NAMESPACE)
+    #define TRAFO_NAMESPACE fw
+#endif
+
+namespace TRAFO_NAMESPACE
+{
+    namespace internal
+    {
+        // loop nests over tiled buffers walk the index space tile by tile, so that the elements of a tile are accessed together:
+        //
+        //      for (int k = 0; k < nz; ++k)            for (int k_tile = 0; k_tile < nz; k_tile += 8)
+        //          for (int j = 0; j < ny; ++j)    ->  for (int j_tile = 0; j_tile < ny; j_tile += 8)
+        //              a[k][j] = ...                   for (int k = k_tile; k < (k_tile + 8 < nz ? k_tile + 8 : nz); ++k)
+        //                                                  for (int j = j_tile; j < (j_tile + 8 < ny ? j_tile + 8 : ny); ++j)
+        //                                                      a[k][j] = ...
+        //
+        // the loops must be perfectly nested, count upwards with unit step between bounds that do not depend on the nest,
+        // and index the buffer with their loop variables (plus constant offsets) in the order of its dimensions.
+        // the iterations are reordered: the loop body must write nothing but the elements of the current iteration
+        // (of any array) and variables declared inside of it
+        class LoopTiling
+        {
+            struct Loop
+            {
+                const clang::ForStmt* forStmt;
+                const clang::VarDecl* variable;
+                const clang::Expr* lowerBound;
+                const clang::Expr* upperBound;
+            };
+
+            struct LoopNest
+            {
+                // tiled buffer that is accessed in the loop body
+                const clang::ValueDecl* decl;
+                std::vector<Loop> loops;
+                std::vector<std::size_t> tileExtent;
+            };
+
+            clang::ASTContext& context;
+            const std::map<const clang::ValueDecl*, std::vector<std::size_t>> tileExtents;
+            std::vector<LoopNest> loopNests;
+
+            static const clang::ValueDecl* getVariable(const clang::Expr& expr)
+            {
+                const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(expr.IgnoreParenImpCasts());
+
+                return (declRefExpr ? declRefExpr->getDecl() : nullptr);
+            }
+
+            // 'for (int i = lower; i < upper; ++i)'
+            static bool getLoop(const clang::ForStmt& forStmt, Loop& loop)
+            {
+                const clang::DeclStmt* const init = llvm::dyn_cast_or_null<clang::DeclStmt>(forStmt.getInit());
+                const clang::VarDecl* const variable = ((init && init->isSingleDecl()) ? llvm::dyn_cast<clang::VarDecl>(init->getSingleDecl()) : nullptr);
+                if (!variable || !variable->getType()->isIntegerType() || !variable->getInit()) return false;
+
+                const clang::BinaryOperator* const cond = llvm::dyn_cast_or_null<clang::BinaryOperator>(forStmt.getCond());
+                if (!cond || cond->getOpcode() != clang::BO_LT || getVariable(*(cond->getLHS())) != variable) return false;
+
+                const clang::UnaryOperator* const inc = llvm::dyn_cast_or_null<clang::UnaryOperator>(forStmt.getInc());
+                if (!inc || !inc->isIncrementOp() || getVariable(*(inc->getSubExpr())) != variable) return false;
+
+                loop = Loop{&forStmt, variable, variable->getInit(), cond->getRHS()};
+
+                return true;
+            }
+
+            // the loop body is the inner loop only (possibly enclosed in braces)
+            static const clang::ForStmt* getInnerLoop(const clang::Stmt* const body)
+            {
+                if (const clang::CompoundStmt* const compoundStmt = llvm::dyn_cast_or_null<clang::CompoundStmt>(body))
+                {
+                    return (compoundStmt->size() == 1 ? getInnerLoop(compoundStmt->body_front()) : nullptr);
+                }
+
+                return llvm::dyn_cast_or_null<clang::ForStmt>(body);
+            }
+
+            static bool refersTo(const clang::Stmt* const stmt, const std::vector<Loop>& loops)
+            {
+                if (!stmt) return false;
+
+                if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(stmt))
+                {
+                    for (const auto& loop : loops)
+                    {
+                        if (declRefExpr->getDecl() == loop.variable) return true;
+                    }
+                }
+
+                for (const clang::Stmt* const child : stmt->children())
+                {
+                    if (refersTo(child, loops)) return true;
+                }
+
+                return false;
+            }
+
+            // 'a[k][j][i]', 'x.a[k][j][i]' or 'a[k][j][i].x[c]' (with 'throughMembers'): returns 'a', 'x.a' or 'a' and the indices
+            static const clang::Expr* getAccess(const clang::Expr& expr, std::vector<const clang::Expr*>& indices, const bool throughMembers)
+            {
+                const clang::Expr* base = expr.IgnoreParenImpCasts();
+                indices.clear();
+
+                while (true)
+                {
+                    const clang::Expr* index = nullptr;
+                    if (const clang::ArraySubscriptExpr* const subscriptExpr = llvm::dyn_cast<clang::ArraySubscriptExpr>(base))
+                    {
+                        index = subscriptExpr->getIdx();
+                        base = subscriptExpr->getBase()->IgnoreParenImpCasts();
+                    }
+                    else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(base))
+                    {
+                        if (operatorCallExpr->getOperator() != clang::OO_Subscript || operatorCallExpr->getNumArgs() != 2) break;
+
+                        index = operatorCallExpr->getArg(1);
+                        base = operatorCallExpr->getArg(0)->IgnoreParenImpCasts();
+                    }
+                    else if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(base))
+                    {
+                        // fields of elements: subscripts of array fields do not index the buffer
+                        if (!throughMembers || memberExpr->isArrow()) break;
+
+                        indices.clear();
+                        base = memberExpr->getBase()->IgnoreParenImpCasts();
+                        continue;
+                    }
+                    else
+                    {
+                        break;
+                    }
+
+                    indices.insert(indices.begin(), index);
+                }
+
+                return base;
+            }
+
+            static const clang::ValueDecl* getReferencedDeclaration(const clang::Expr* const expr)
+            {
+                if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast_or_null<clang::DeclRefExpr>(expr))
+                {
+                    return declRefExpr->getDecl();
+                }
+                else if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast_or_null<clang::MemberExpr>(expr))
+                {
+                    return memberExpr->getMemberDecl();
+                }
+
+                return nullptr;
+            }
+
+            // 'i' or 'i + 1', 'i - 1', ...
+            bool isLoopIndex(const clang::Expr& index, const clang::VarDecl& variable) const
+            {
+                const clang::Expr* const expr = index.IgnoreParenImpCasts();
+                if (getVariable(*expr) == &variable) return true;
+
+                const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast<clang::BinaryOperator>(expr);
+                if (!binaryOperator || !(binaryOperator->getOpcode() == clang::BO_Add || binaryOperator->getOpcode() == clang::BO_Sub)) return false;
+
+                return (getVariable(*(binaryOperator->getLHS())) == &variable && binaryOperator->getRHS()->isIntegerConstantExpr(context));
+            }
+
+            // 'a[k][j][i]' with 'k', 'j' and 'i' being the loop variables of the nest
+            static bool isCurrentElement(const std::vector<const clang::Expr*>& indices, const std::vector<Loop>& loops)
+            {
+                if (indices.size() != loops.size()) return false;
+
+                for (std::size_t i = 0; i < indices.size(); ++i)
+                {
+                    if (getVariable(*indices[i]) != loops[i].variable) return false;
+                }
+
+                return true;
+            }
+
+            // tiled buffer accessed with the loop variables of the outermost loops of the chain: returns the number of these loops
+            std::size_t findTiledAccess(const clang::Stmt* const stmt, const std::vector<Loop>& loops, const clang::ValueDecl*& decl) const
+            {
+                if (!stmt) return 0;
+
+                if (const clang::Expr* const expr = llvm::dyn_cast<clang::Expr>(stmt))
+                {
+                    std::vector<const clang::Expr*> indices;
+                    const clang::ValueDecl* const base = getReferencedDeclaration(getAccess(*expr, indices, false));
+                    const auto tileExtent = tileExtents.find(base);
+
+                    if (tileExtent != tileExtents.end() && indices.size() == tileExtent->second.size() && indices.size() <= loops.size())
+                    {
+                        bool isTiledAccess = true;
+                        for (std::size_t i = 0; i < indices.size(); ++i)
+                        {
+                            isTiledAccess &= isLoopIndex(*indices[i], *(loops[i].variable));
+                        }
+
+                        if (isTiledAccess)
+                        {
+                            decl = base;
+                            return indices.size();
+                        }
+                    }
+                }
+
+                for (const clang::Stmt* const child : stmt->children())
+                {
+                    if (const std::size_t numLoops = findTiledAccess(child, loops, decl)) return numLoops;
+                }
+
+                return 0;
+            }
+
+            bool isLocalVariable(const clang::ValueDecl& decl, const clang::Stmt& body) const
+            {
+                const clang::VarDecl* const variable = llvm::dyn_cast<clang::VarDecl>(&decl);
+                if (!variable || !variable->isLocalVarDecl() || variable->isStaticLocal()) return false;
+
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+                const clang::SourceLocation location = variable->getLocation();
+
+                return (!sourceManager.isBeforeInTranslationUnit(location, body.getBeginLoc()) && sourceManager.isBeforeInTranslationUnit(location, body.getEndLoc()));
+            }
+
+            // the target of a write is a local variable or the element of the current iteration
+            bool isIterationPrivate(const clang::Expr& target, const std::vector<Loop>& loops, const clang::Stmt& body, std::set<const clang::ValueDecl*>& writtenDeclarations) const
+            {
+                std::vector<const clang::Expr*> indices;
+                const clang::ValueDecl* const decl = getReferencedDeclaration(getAccess(target, indices, true));
+                if (!decl) return false;
+
+                if (isLocalVariable(*decl, body))
+                {
+                    // references must be bound to local variables or to elements of the current iteration
+                    const clang::VarDecl* const variable = llvm::dyn_cast<clang::VarDecl>(decl);
+                    if (!variable->getType()->isReferenceType()) return true;
+
+                    return (variable->getInit() && isIterationPrivate(*(variable->getInit()), loops, body, writtenDeclarations));
+                }
+
+                if (!isCurrentElement(indices, loops)) return false;
+
+                writtenDeclarations.insert(decl);
+
+                return true;
+            }
+
+            static bool isAssignmentOperator(const clang::OverloadedOperatorKind op)
+            {
+                switch (op)
+                {
+                    case clang::OO_Equal:
+                    case clang::OO_PlusEqual:
+                    case clang::OO_MinusEqual:
+                    case clang::OO_StarEqual:
+                    case clang::OO_SlashEqual:
+                    case clang::OO_PercentEqual:
+                    case clang::OO_AmpEqual:
+                    case clang::OO_PipeEqual:
+                    case clang::OO_CaretEqual:
+                    case clang::OO_LessLessEqual:
+                    case clang::OO_GreaterGreaterEqual:
+                    case clang::OO_PlusPlus:
+                    case clang::OO_MinusMinus:
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+
+            // returns false and the reason if the iterations of the loop body cannot be reordered
+            bool isReorderable(const clang::Stmt* const stmt, const std::vector<Loop>& loops, const clang::Stmt& body, std::set<const clang::ValueDecl*>& writtenDeclarations, std::string& reason, const bool isInsideInnerLoop = false) const
+            {
+                if (!stmt) return true;
+
+                const clang::Expr* target = nullptr;
+                if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast<clang::BinaryOperator>(stmt))
+                {
+                    if (binaryOperator->isAssignmentOp()) target = binaryOperator->getLHS();
+                }
+                else if (const clang::UnaryOperator* const unaryOperator = llvm::dyn_cast<clang::UnaryOperator>(stmt))
+                {
+                    if (unaryOperator->isIncrementDecrementOp()) target = unaryOperator->getSubExpr();
+                }
+                else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(stmt))
+                {
+                    if (isAssignmentOperator(operatorCallExpr->getOperator())) target = operatorCallExpr->getArg(0);
+
+                    if (operatorCallExpr->getOperator() == clang::OO_Call)
+                    {
+                        reason = std::string("call of a function object");
+                        return false;
+                    }
+                }
+                else if (const clang::CXXMemberCallExpr* const memberCallExpr = llvm::dyn_cast<clang::CXXMemberCallExpr>(stmt))
+                {
+                    const clang::CXXMethodDecl* const method = memberCallExpr->getMethodDecl();
+                    if (!method || !method->isConst())
+                    {
+                        reason = std::string("call of non-const method ") + (method ? method->getNameAsString() : std::string(""));
+                        return false;
+                    }
+                }
+                else if (const clang::CallExpr* const callExpr = llvm::dyn_cast<clang::CallExpr>(stmt))
+                {
+                    // standard library functions taking no non-const pointers or references, e.g. math functions
+                    const clang::FunctionDecl* const callee = callExpr->getDirectCallee();
+                    bool isPure = (callee && (callee->isInStdNamespace() || context.getSourceManager().isInSystemHeader(callee->getLocation())));
+                    for (std::uint32_t i = 0; isPure && i < callee->getNumParams(); ++i)
+                    {
+                        const clang::QualType type = callee->getParamDecl(i)->getType();
+                        isPure &= !((type->isReferenceType() || type->isPointerType()) && !type->getPointeeType().isConstQualified());
+                    }
+
+                    if (!isPure)
+                    {
+                        reason = std::string("call of ") + (callee ? callee->getNameAsString() : std::string("a function pointer"));
+                        return false;
+                    }
+                }
+                else if (llvm::isa<clang::ReturnStmt>(stmt) || llvm::isa<clang::GotoStmt>(stmt) || (llvm::isa<clang::BreakStmt>(stmt) && !isInsideInnerLoop))
+                {
+                    reason = std::string("the loop nest is left early");
+                    return false;
+                }
+                else if (llvm::isa<clang::AsmStmt>(stmt))
+                {
+                    reason = std::string("inline assembly");
+                    return false;
+                }
+
+                if (target && !isIterationPrivate(*target, loops, body, writtenDeclarations))
+                {
+                    reason = std::string("write to ") + dumpTokenRangeToString(target->getSourceRange(), context.getSourceManager()) + std::string(" other than to the element of the current iteration");
+                    return false;
+                }
+
+                const bool isLoop = (llvm::isa<clang::ForStmt>(stmt) || llvm::isa<clang::CXXForRangeStmt>(stmt) || llvm::isa<clang::WhileStmt>(stmt) || llvm::isa<clang::DoStmt>(stmt) || llvm::isa<clang::SwitchStmt>(stmt));
+                for (const clang::Stmt* const child : stmt->children())
+                {
+                    if (!isReorderable(child, loops, body, writtenDeclarations, reason, isInsideInnerLoop || isLoop)) return false;
+                }
+
+                return true;
+            }
+
+            // written arrays are read at the element of the current iteration only: 'a[k][j][i] = a[k][j][i + 1]' is refused
+            void collectReferences(const clang::Stmt* const stmt, const std::vector<Loop>& loops, const std::set<const clang::ValueDecl*>& writtenDeclarations, std::vector<const clang::Expr*>& references, std::set<const clang::Expr*>& currentElementReferences) const
+            {
+                if (!stmt) return;
+
+                if (const clang::Expr* const expr = llvm::dyn_cast<clang::Expr>(stmt))
+                {
+                    // data members are referenced through 'this'
+                    const bool isReference = (llvm::isa<clang::DeclRefExpr>(expr) || (llvm::isa<clang::MemberExpr>(expr) && llvm::cast<clang::MemberExpr>(expr)->isArrow()));
+                    if (isReference && writtenDeclarations.find(getReferencedDeclaration(expr)) != writtenDeclarations.end())
+                    {
+                        references.push_back(expr);
+                    }
+
+                    std::vector<const clang::Expr*> indices;
+                    const clang::Expr* const base = getAccess(*expr, indices, false);
+                    if (isCurrentElement(indices, loops))
+                    {
+                        currentElementReferences.insert(base);
+                    }
+                }
+
+                for (const clang::Stmt* const child : stmt->children())
+                {
+                    collectReferences(child, loops, writtenDeclarations, references, currentElementReferences);
+                }
+            }
+
+            std::string getSourceText(const clang::Expr& expr) const
+            {
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+                const clang::CharSourceRange sourceRange = sourceManager.getExpansionRange(expr.getSourceRange());
+
+                return clang::Lexer::getSourceText(clang::CharSourceRange::getTokenRange(sourceRange.getBegin(), sourceRange.getEnd()), sourceManager, context.getLangOpts()).str();
+            }
+
+            void replaceText(const clang::Expr& expr, const std::string& text, Rewriter& rewriter) const
+            {
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+                const clang::CharSourceRange sourceRange = sourceManager.getExpansionRange(expr.getSourceRange());
+                const clang::FileID fileId = sourceManager.getFileID(sourceRange.getBegin());
+                const std::size_t begin = sourceManager.getFileOffset(sourceRange.getBegin());
+                const std::size_t end = sourceManager.getFileOffset(sourceRange.getEnd()) + clang::Lexer::MeasureTokenLength(sourceRange.getEnd(), sourceManager, context.getLangOpts());
+
+                rewriter.getEditBuffer(fileId).ReplaceText(begin, end - begin, text);
+            }
+
+            void findLoopNests()
+            {
+                using namespace clang::ast_matchers;
+
+                std::vector<const clang::ForStmt*> forStmts;
+
+                Matcher matcher;
+                matcher.addMatcher(forStmt(unless(isExpansionInSystemHeader()), unless(isInTemplateInstantiation())).bind("loop"),
+                    [&forStmts] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::ForStmt* const forStmt = result.Nodes.getNodeAs<clang::ForStmt>("loop")) forStmts.push_back(forStmt);
+                    });
+                matcher.run(context);
+
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+
+                // note: outer loops are matched before the loops nested in them
+                for (const auto forStmt : forStmts)
+                {
+                    if (forStmt->getBeginLoc().isMacroID()) continue;
+
+                    // loops inside of tiled loop nests are not tiled again
+                    bool isInsideLoopNest = false;
+                    for (const auto& loopNest : loopNests)
+                    {
+                        const clang::ForStmt& outerLoop = *(loopNest.loops[0].forStmt);
+                        isInsideLoopNest |= (!sourceManager.isBeforeInTranslationUnit(forStmt->getBeginLoc(), outerLoop.getBeginLoc()) && !sourceManager.isBeforeInTranslationUnit(outerLoop.getEndLoc(), forStmt->getBeginLoc()));
+                    }
+                    if (isInsideLoopNest) continue;
+
+                    std::vector<Loop> loops;
+                    Loop nextLoop;
+                    for (const clang::ForStmt* innerLoop = forStmt; innerLoop && getLoop(*innerLoop, nextLoop); innerLoop = getInnerLoop(innerLoop->getBody()))
+                    {
+                        loops.push_back(nextLoop);
+                    }
+                    if (loops.size() < 2) continue;
+
+                    const clang::ValueDecl* decl = nullptr;
+                    const std::size_t numLoops = findTiledAccess(loops.back().forStmt->getBody(), loops, decl);
+                    if (numLoops == 0) continue;
+
+                    loops.resize(numLoops);
+                    const clang::Stmt& body = *(loops.back().forStmt->getBody());
+                    const std::string location = forStmt->getSourceRange().printToString(sourceManager);
+
+                    // rectangular index space
+                    bool isRectangular = true;
+                    for (const auto& loop : loops)
+                    {
+                        isRectangular &= !(refersTo(loop.lowerBound, loops) || refersTo(loop.upperBound, loops));
+                        isRectangular &= !(loop.lowerBound->HasSideEffects(context) || loop.upperBound->HasSideEffects(context));
+                    }
+
+                    if (!isRectangular)
+                    {
+                        std::cerr << "warning: loop nest over tiled buffer " << decl->getNameAsString() << " in " << location << " has bounds that depend on the nest -> not tiled" << std::endl;
+                        continue;
+                    }
+
+                    std::set<const clang::ValueDecl*> writtenDeclarations;
+                    std::string reason;
+                    if (!isReorderable(&body, loops, body, writtenDeclarations, reason))
+                    {
+                        std::cerr << "warning: loop nest over tiled buffer " << decl->getNameAsString() << " in " << location << " cannot be reordered (" << reason << ") -> not tiled" << std::endl;
+                        continue;
+                    }
+
+                    std::vector<const clang::Expr*> references;
+                    std::set<const clang::Expr*> currentElementReferences;
+                    collectReferences(&body, loops, writtenDeclarations, references, currentElementReferences);
+
+                    bool hasCarriedDependences = false;
+                    for (const auto reference : references)
+                    {
+                        hasCarriedDependences |= (currentElementReferences.find(reference) == currentElementReferences.end());
+                    }
+
+                    if (hasCarriedDependences)
+                    {
+                        std::cerr << "warning: loop nest over tiled buffer " << decl->getNameAsString() << " in " << location << " reads elements of other iterations of written arrays -> not tiled" << std::endl;
+                        continue;
+                    }
+
+                    loopNests.push_back(LoopNest{decl, loops, tileExtents.at(decl)});
+                }
+            }
+
+        public:
+
+            LoopTiling(const std::map<const clang::ValueDecl*, std::vector<std::size_t>>& tileExtents, clang::ASTContext& context)
+                :
+                context(context),
+                tileExtents(tileExtents)
+            {
+                if (tileExtents.empty()) return;
+
+                findLoopNests();
+            }
+
+            void modifyLoops(Rewriter& rewriter, std::set<clang::FileID>& outputFiles)
+            {
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+
+                for (const auto& loopNest : loopNests)
+                {
+                    const clang::SourceLocation begin = loopNest.loops[0].forStmt->getBeginLoc();
+                    const clang::FileID fileId = sourceManager.getFileID(begin);
+
+                    // indentation of the loop nest
+                    std::string indent = dumpSourceRangeToString(clang::SourceRange(getBeginOfLine(begin, context), begin), sourceManager);
+                    indent = indent.substr(0, indent.find_first_not_of(" \t"));
+
+                    std::stringstream tileLoops;
+                    for (std::size_t i = 0; i < loopNest.loops.size(); ++i)
+                    {
+                        const Loop& loop = loopNest.loops[i];
+                        const std::string typeName = loop.variable->getType().getUnqualifiedType().getAsString(context.getPrintingPolicy());
+                        const std::string tileName = loop.variable->getNameAsString() + std::string("_tile");
+                        const std::string tileEnd = tileName + std::string(" + ") + std::to_string(loopNest.tileExtent[i]);
+                        const std::string upperBound = getSourceText(*(loop.upperBound));
+
+                        tileLoops << "for (" << typeName << " " << tileName << " = " << getSourceText(*(loop.lowerBound)) << "; " << tileName << " < " << upperBound << "; " << tileName << " += " << loopNest.tileExtent[i] << ")\n" << indent;
+
+                        replaceText(*(loop.lowerBound), tileName, rewriter);
+                        replaceText(*(loop.upperBound), std::string("(") + tileEnd + std::string(" < ") + upperBound + std::string(" ? ") + tileEnd + std::string(" : ") + upperBound + std::string(")"), rewriter);
+                    }
+
+                    rewriter.getEditBuffer(fileId).InsertTextBefore(sourceManager.getFileOffset(begin), tileLoops.str());
+                    outputFiles.insert(fileId);
+                }
+            }
+
+            void printInfo(const std::string indent = std::string("")) const
+            {
+                std::cout << indent << "LOOP TILING (" << loopNests.size() << " loop nests)" << std::endl;
+                for (const auto& loopNest : loopNests)
+                {
+                    std::cout << indent << "\t* " << loopNest.decl->getNameAsString() << " in " << loopNest.loops[0].forStmt->getSourceRange().printToString(context.getSourceManager()) << ":";
+                    for (std::size_t i = 0; i < loopNest.loops.size(); ++i)
+                    {
+                        std::cout << " " << loopNest.loops[i].variable->getNameAsString() << "(" << loopNest.tileExtent[i] << ")";
+                    }
+                    std::cout << std::endl;
+                }
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,643 @@
+// Copyright (c) 2017-2019 Florian Wende (flwende@gmail.com)
+//
+// Distributed under the BSD 2-clause Software License
+// (See accompanying file LICENSE)
+
+#if !defined(TRAFO_DATA_LAYOUT_PARAMETER_PROPAGATION_HPP)
+#define TRAFO_DATA_LAYOUT_PARAMETER_PROPAGATION_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <clang/Lex/Lexer.h>
+
+#include <misc/ast_helper.hpp>
+#include <misc/matcher.hpp>
+#include <misc/rewriter.hpp>
+#include <trafo/data_layout/variable_declaration.hpp>
+
+#if !defined(TRAFO_NAMESPACE)
+    #define TRAFO_NAMESPACE fw
+#endif
+
+namespace TRAFO_NAMESPACE
+{
+    namespace internal
+    {
+        // transformed declarations that are passed to functions turn the corresponding parameters into buffers or views:
+        //
+        //      void foo(std::vector<T>& v)     ->  void foo(XXX_NAMESPACE::buffer<T, 1, ...>& v)
+        //      void foo(const T* p, int n)     ->  void foo(XXX_NAMESPACE::strided_view<const T, 1, XXX_NAMESPACE::data_layout::SoA> p, int n)
+        //
+        // views are non-owning (base pointers of the field streams, extents and strides): element pointers into a buffer
+        // like '&v[begin]' or '&field[j][0]' become 'v.subrange(begin)' and 'field.slice(j)' at the call site
+        //
+        // the propagation continues through these parameters into further calls. functions that are also called with
+        // untransformed arguments keep an unmodified copy next to the adapted version (overloading on the parameter types)
+        class ParameterPropagation
+        {
+            struct Entity
+            {
+                // the transformed declaration that is passed (through any number of calls)
+                const Declaration* declaration;
+                const std::string bufferTypeName;
+                const clang::QualType type;
+                const clang::QualType elementDataType;
+                const std::string elementDataTypeSpelling;
+                const std::uint32_t numDimensions;
+                // arrays, raw heap arrays and pointer parameters are passed as element pointers
+                const bool isElementPointer;
+                // 'v.data()' is an element pointer as well
+                const bool providesData;
+                // element ranges can be described by a view
+                const bool isStrided;
+            };
+
+            struct Argument
+            {
+                const Entity* entity;
+                // 'p', 'v.data()', '&v[i]', 'p + i'
+                bool isElementPointer;
+                // source text that replaces the argument (empty if unchanged)
+                std::string replacement;
+            };
+
+            struct Call
+            {
+                const clang::CallExpr& callExpr;
+                // function definition containing the call (if any)
+                const clang::FunctionDecl* const caller;
+                // function definition if available
+                const clang::FunctionDecl& callee;
+            };
+
+            struct Function
+            {
+                // buffer or view type names by parameter index
+                std::map<std::uint32_t, std::string> parameterTypeNames;
+                bool keepOriginal;
+            };
+
+            clang::ASTContext& context;
+            std::map<const clang::ValueDecl*, Entity> entities;
+            std::vector<Call> calls;
+            std::map<const clang::FunctionDecl*, Function> functions;
+            // parameters that cannot be adapted, together with the reason (empty for generic parameters)
+            std::map<const clang::ParmVarDecl*, std::string> rejectedParameters;
+            std::map<const clang::ParmVarDecl*, std::vector<const clang::DeclRefExpr*>> parameterReferences;
+            // declarations with calls that cannot be adapted, together with the reason
+            std::map<const Declaration*, std::string> nonAdaptableDeclarations;
+            std::vector<std::string> warnings;
+
+            static const clang::FunctionDecl* getEnclosingFunction(const clang::Stmt& stmt, clang::ASTContext& context)
+            {
+                auto parents = context.getParents(stmt);
+
+                while (!parents.empty())
+                {
+                    if (const clang::FunctionDecl* const function = parents[0].get<clang::FunctionDecl>()) return function;
+
+                    parents = context.getParents(parents[0]);
+                }
+
+                return nullptr;
+            }
+
+            // 'v', 'p' or 'x.v'
+            const Entity* getEntity(const clang::Expr& expr) const
+            {
+                const clang::ValueDecl* decl = nullptr;
+                if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(&expr))
+                {
+                    decl = declRefExpr->getDecl();
+                }
+                else if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(&expr))
+                {
+                    decl = memberExpr->getMemberDecl();
+                }
+
+                const auto it = (decl ? entities.find(decl) : entities.end());
+
+                return (it != entities.end() ? &(it->second) : nullptr);
+            }
+
+            std::string getSourceText(const clang::Expr& expr) const
+            {
+                return dumpTokenRangeToString(expr.getSourceRange(), context.getSourceManager());
+            }
+
+            static const clang::Expr* getSubscriptBase(const clang::Expr& expr, const clang::Expr*& index)
+            {
+                if (const clang::ArraySubscriptExpr* const subscriptExpr = llvm::dyn_cast<clang::ArraySubscriptExpr>(&expr))
+                {
+                    index = subscriptExpr->getIdx();
+                    return subscriptExpr->getBase()->IgnoreParenImpCasts();
+                }
+
+                if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(&expr))
+                {
+                    if (operatorCallExpr->getOperator() == clang::OO_Subscript && operatorCallExpr->getNumArgs() == 2)
+                    {
+                        index = operatorCallExpr->getArg(1);
+                        return operatorCallExpr->getArg(0)->IgnoreParenImpCasts();
+                    }
+                }
+
+                return nullptr;
+            }
+
+            // 'v', 'x.v', 'v.data()', '&v[i]', '&field[j][i]', 'p + i' or 'v.data() + i'
+            Argument getArgument(const clang::Expr& argument) const
+            {
+                const clang::Expr* const expr = argument.IgnoreParenImpCasts();
+
+                if (const Entity* const entity = getEntity(*expr))
+                {
+                    return Argument{entity, entity->isElementPointer, std::string("")};
+                }
+
+                // 'v.data()' -> 'v'
+                if (const clang::CXXMemberCallExpr* const memberCallExpr = llvm::dyn_cast<clang::CXXMemberCallExpr>(expr))
+                {
+                    const clang::CXXMethodDecl* const method = memberCallExpr->getMethodDecl();
+                    if (method && method->getNameAsString() == std::string("data") && memberCallExpr->getNumArgs() == 0)
+                    {
+                        const clang::Expr* const object = memberCallExpr->getImplicitObjectArgument()->IgnoreParenImpCasts();
+                        const Entity* const entity = getEntity(*object);
+                        if (entity && entity->providesData) return Argument{entity, true, getSourceText(*object)};
+                    }
+                }
+                // 'p + i' -> 'p.subrange(i)'
+                else if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast<clang::BinaryOperator>(expr))
+                {
+                    if (binaryOperator->getOpcode() == clang::BO_Add)
+                    {
+                        const bool isOffsetLeft = binaryOperator->getLHS()->getType()->isIntegerType();
+                        const clang::Expr& pointer = *(isOffsetLeft ? binaryOperator->getRHS() : binaryOperator->getLHS());
+                        const clang::Expr& offset = *(isOffsetLeft ? binaryOperator->getLHS() : binaryOperator->getRHS());
+                        const Argument base = getArgument(pointer);
+
+                        if (base.entity && base.isElementPointer && base.entity->numDimensions == 1)
+                        {
+                            const std::string baseText = (base.replacement != std::string("") ? base.replacement : getSourceText(*(pointer.IgnoreParenImpCasts())));
+                            return Argument{base.entity, true, baseText + std::string(".subrange(") + getSourceText(offset) + std::string(")")};
+                        }
+                    }
+                }
+                // '&v[i]' -> 'v.subrange(i)', '&field[j][i]' -> 'field.slice(j).subrange(i)'
+                else if (const clang::UnaryOperator* const unaryOperator = llvm::dyn_cast<clang::UnaryOperator>(expr))
+                {
+                    if (unaryOperator->getOpcode() == clang::UO_AddrOf)
+                    {
+                        std::vector<const clang::Expr*> indices;
+                        const clang::Expr* base = unaryOperator->getSubExpr()->IgnoreParenImpCasts();
+                        const clang::Expr* index = nullptr;
+                        while (const clang::Expr* const innerBase = getSubscriptBase(*base, index))
+                        {
+                            indices.insert(indices.begin(), index);
+                            base = innerBase;
+                        }
+
+                        const Entity* const entity = getEntity(*base);
+                        if (entity && indices.size() == entity->numDimensions)
+                        {
+                            std::string replacement = getSourceText(*base);
+                            for (std::size_t i = 0; i < (indices.size() - 1); ++i)
+                            {
+                                replacement += std::string(".slice(") + getSourceText(*indices[i]) + std::string(")");
+                            }
+                            const std::string lastIndex = getSourceText(*indices.back());
+                            if (lastIndex != std::string("0"))
+                            {
+                                replacement += std::string(".subrange(") + lastIndex + std::string(")");
+                            }
+
+                            return Argument{entity, true, replacement};
+                        }
+                    }
+                }
+
+                return Argument{nullptr, false, std::string("")};
+            }
+
+            // element pointers can become views only if they are indexed or passed on to other functions (possibly with an offset)
+            // reason why the parameters of a function definition cannot be adapted (empty if they can)
+            std::string getNonAdaptableReason(const clang::FunctionDecl& callee) const
+            {
+                if (!callee.doesThisDeclarationHaveABody()) return std::string("has no definition in this translation unit");
+
+                if (context.getSourceManager().isInSystemHeader(callee.getLocation())) return std::string("is defined in a system header");
+
+                if (const clang::CXXMethodDecl* const method = llvm::dyn_cast<clang::CXXMethodDecl>(&callee))
+                {
+                    if (method->isVirtual()) return std::string("is virtual");
+                }
+
+                return std::string("");
+            }
+
+            // element pointers can be passed on to functions whose parameter becomes a view as well: library functions, for instance, cannot be adapted
+            bool isPassedToAdaptableParameter(const clang::CallExpr& callExpr, const clang::Expr& argument, std::set<const clang::ParmVarDecl*>& visitedParameters) const
+            {
+                if (llvm::isa<clang::CXXOperatorCallExpr>(&callExpr) || callExpr.getCallee()->IgnoreParenImpCasts() == &argument) return false;
+
+                const clang::FunctionDecl* const callee = callExpr.getDirectCallee();
+                const clang::FunctionDecl* definition = nullptr;
+                if (!callee || !callee->hasBody(definition) || !definition) return false;
+
+                if (definition->getTemplateInstantiationPattern() || getNonAdaptableReason(*definition) != std::string("")) return false;
+
+                for (std::uint32_t i = 0; i < callExpr.getNumArgs() && i < definition->getNumParams(); ++i)
+                {
+                    if (callExpr.getArg(i)->IgnoreParenImpCasts() != &argument) continue;
+
+                    const clang::ParmVarDecl& param = *definition->getParamDecl(i);
+
+                    return (param.getType()->isPointerType() && isUsedForIndexingOnly(param, visitedParameters));
+                }
+
+                return false;
+            }
+
+            bool isUsedForIndexingOnly(const clang::ParmVarDecl& param, std::set<const clang::ParmVarDecl*>& visitedParameters) const
+            {
+                // recursive calls
+                if (!visitedParameters.insert(&param).second) return true;
+
+                const auto it = parameterReferences.find(&param);
+                if (it == parameterReferences.end()) return true;
+
+                for (const clang::DeclRefExpr* const declRefExpr : it->second)
+                {
+                    const clang::Expr* argument = declRefExpr;
+                    const clang::Stmt* parent = getParentIgnoringImplicitCode(*declRefExpr, context);
+                    const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast_or_null<clang::BinaryOperator>(parent);
+                    if (binaryOperator && binaryOperator->getOpcode() == clang::BO_Add)
+                    {
+                        argument = binaryOperator;
+                        parent = getParentIgnoringImplicitCode(*binaryOperator, context);
+                        if (!parent || !llvm::isa<clang::CallExpr>(parent)) return false;
+                    }
+
+                    if (const clang::ArraySubscriptExpr* const subscriptExpr = llvm::dyn_cast_or_null<clang::ArraySubscriptExpr>(parent))
+                    {
+                        if (subscriptExpr->getBase()->IgnoreParenImpCasts() == declRefExpr) continue;
+                    }
+                    else if (const clang::CallExpr* const callExpr = llvm::dyn_cast_or_null<clang::CallExpr>(parent))
+                    {
+                        if (isPassedToAdaptableParameter(*callExpr, *argument, visitedParameters)) continue;
+                    }
+
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool isUsedForIndexingOnly(const clang::ParmVarDecl& param) const
+            {
+                std::set<const clang::ParmVarDecl*> visitedParameters;
+
+                return isUsedForIndexingOnly(param, visitedParameters);
+            }
+
+            bool isCompatible(const Argument& argument, const clang::ParmVarDecl& param) const
+            {
+                const clang::QualType paramType = param.getType();
+
+                if (paramType->isPointerType())
+                {
+                    return (argument.isElementPointer && context.hasSameUnqualifiedType(paramType->getPointeeType(), argument.entity->elementDataType) && isUsedForIndexingOnly(param));
+                }
+
+                return (!argument.isElementPointer && context.hasSameUnqualifiedType(paramType.getNonReferenceType(), argument.entity->type));
+            }
+
+            // element pointers become views (passed by value), containers become buffers
+            static std::string getParameterTypeName(const Argument& argument, const clang::ParmVarDecl& param)
+            {
+                const clang::QualType paramType = param.getType();
+
+                if (paramType->isPointerType())
+                {
+                    return std::string("XXX_NAMESPACE::strided_view<") + (paramType->getPointeeType().isConstQualified() ? std::string("const ") : std::string("")) +
+                        argument.entity->elementDataTypeSpelling + std::string(", 1, XXX_NAMESPACE::data_layout::SoA>");
+                }
+
+                return (paramType.getNonReferenceType().isConstQualified() ? std::string("const ") : std::string("")) + argument.entity->bufferTypeName +
+                    (paramType->isLValueReferenceType() ? std::string("&") : (paramType->isRValueReferenceType() ? std::string("&&") : std::string("")));
+            }
+
+            // the message is empty if the parameter is generic
+            bool isAdaptable(const Call& call, const std::uint32_t argumentIndex, const Argument& argument, std::string& message) const
+            {
+                const clang::FunctionDecl& callee = call.callee;
+                const clang::ParmVarDecl& param = *callee.getParamDecl(argumentIndex);
+                std::string reason;
+
+                if (const clang::FunctionDecl* const pattern = callee.getTemplateInstantiationPattern())
+                {
+                    // generic parameters accept buffers as they are
+                    if (argumentIndex < pattern->getNumParams() && pattern->getParamDecl(argumentIndex)->getType().getNonReferenceType()->getAs<clang::TemplateTypeParmType>()) return false;
+
+                    reason = std::string("is a template instantiation");
+                }
+                else
+                {
+                    reason = getNonAdaptableReason(callee);
+                }
+
+                if (reason == std::string("") && !isCompatible(argument, param))
+                {
+                    reason = std::string("uses parameter ") + param.getNameAsString() + std::string(" other than as a container or for indexing");
+                }
+                else if (reason == std::string("") && argument.isElementPointer && !argument.entity->isStrided)
+                {
+                    reason = std::string("takes an element pointer, which has no view for this buffer layout");
+                }
+
+                if (reason != std::string(""))
+                {
+                    std::stringstream messageStream;
+                    messageStream << "argument " << (argumentIndex + 1) << " of the call to " << callee.getNameAsString() << " in " << call.callExpr.getSourceRange().printToString(context.getSourceManager())
+                        << " is a buffer, but the function " << reason;
+                    message = messageStream.str();
+
+                    return false;
+                }
+
+                return true;
+            }
+
+            void findCalls()
+            {
+                using namespace clang::ast_matchers;
+
+                Matcher matcher;
+                matcher.addMatcher(callExpr(unless(isExpansionInSystemHeader()), unless(isInTemplateInstantiation()), unless(cxxOperatorCallExpr())).bind("call"),
+                    [this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        const clang::CallExpr* const callExpr = result.Nodes.getNodeAs<clang::CallExpr>("call");
+                        const clang::FunctionDecl* callee = (callExpr ? callExpr->getDirectCallee() : nullptr);
+                        if (!callee) return;
+
+                        const clang::FunctionDecl* definition = nullptr;
+                        if (callee->isDefined(definition)) callee = definition;
+
+                        calls.push_back(Call{*callExpr, getEnclosingFunction(*callExpr, context), *callee});
+                    });
+                matcher.addMatcher(declRefExpr(to(parmVarDecl()), unless(isExpansionInSystemHeader())).bind("parameterRef"),
+                    [this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::DeclRefExpr* const declRefExpr = result.Nodes.getNodeAs<clang::DeclRefExpr>("parameterRef"))
+                        {
+                            parameterReferences[llvm::dyn_cast<clang::ParmVarDecl>(declRefExpr->getDecl())].push_back(declRefExpr);
+                        }
+                    });
+                matcher.run(context);
+            }
+
+            void propagate()
+            {
+                // step 1: follow the arguments into the called functions until nothing changes
+                bool changed = true;
+                while (changed)
+                {
+                    changed = false;
+
+                    for (const auto& call : calls)
+                    {
+                        for (std::uint32_t i = 0; i < call.callExpr.getNumArgs() && i < call.callee.getNumParams(); ++i)
+                        {
+                            const Argument argument = getArgument(*call.callExpr.getArg(i));
+                            if (!argument.entity) continue;
+
+                            // all declarations passed to a parameter that cannot be adapted must not be transformed
+                            const clang::ParmVarDecl* const param = call.callee.getParamDecl(i);
+                            const auto rejectedParameter = rejectedParameters.find(param);
+                            if (rejectedParameter != rejectedParameters.end())
+                            {
+                                if (rejectedParameter->second != std::string("")) nonAdaptableDeclarations.insert(std::make_pair(argument.entity->declaration, rejectedParameter->second));
+                                continue;
+                            }
+
+                            auto function = functions.find(&call.callee);
+                            if (function == functions.end() || function->second.parameterTypeNames.find(i) == function->second.parameterTypeNames.end())
+                            {
+                                std::string message;
+                                if (!isAdaptable(call, i, argument, message))
+                                {
+                                    rejectedParameters[param] = message;
+                                    if (message != std::string("")) nonAdaptableDeclarations.insert(std::make_pair(argument.entity->declaration, message));
+                                    continue;
+                                }
+
+                                if (function == functions.end())
+                                {
+                                    function = functions.insert(std::make_pair(&call.callee, Function{std::map<std::uint32_t, std::string>(), false})).first;
+                                }
+                                function->second.parameterTypeNames[i] = getParameterTypeName(argument, *param);
+
+                                const Entity& entity = *(argument.entity);
+                                const bool isView = param->getType()->isPointerType();
+                                entities.insert(std::make_pair(param, Entity{entity.declaration, entity.bufferTypeName, param->getType().getNonReferenceType(), entity.elementDataType, entity.elementDataTypeSpelling,
+                                    (isView ? 1 : entity.numDimensions), isView, !isView && entity.providesData, isView || entity.isStrided}));
+                                changed = true;
+                            }
+                        }
+                    }
+                }
+
+                // step 2: calls with untransformed arguments need the original function
+                for (const auto& call : calls)
+                {
+                    const auto function = functions.find(&call.callee);
+                    if (function == functions.end()) continue;
+
+                    for (const auto& parameter : function->second.parameterTypeNames)
+                    {
+                        const Argument argument = (parameter.first < call.callExpr.getNumArgs() ? getArgument(*call.callExpr.getArg(parameter.first)) : Argument{nullptr, false, std::string("")});
+
+                        if (!argument.entity)
+                        {
+                            function->second.keepOriginal = true;
+                        }
+                        else if (getParameterTypeName(argument, *call.callee.getParamDecl(parameter.first)) != parameter.second)
+                        {
+                            std::stringstream message;
+                            message << "warning: argument " << (parameter.first + 1) << " of the call to " << call.callee.getNameAsString() << " in " << call.callExpr.getSourceRange().printToString(context.getSourceManager())
+                                << " is a buffer of type " << argument.entity->bufferTypeName << ", but the function is adapted for " << parameter.second << " -> adapt the call manually";
+                            warnings.push_back(message.str());
+                        }
+                    }
+                }
+
+                // step 3: the unmodified copy of a function passes untransformed arguments to the functions it calls
+                changed = true;
+                while (changed)
+                {
+                    changed = false;
+
+                    for (const auto& call : calls)
+                    {
+                        const auto caller = (call.caller ? functions.find(call.caller) : functions.end());
+                        if (caller == functions.end() || !caller->second.keepOriginal) continue;
+
+                        const auto callee = functions.find(&call.callee);
+                        if (callee == functions.end() || callee->second.keepOriginal) continue;
+
+                        callee->second.keepOriginal = true;
+                        changed = true;
+                    }
+                }
+            }
+
+        public:
+
+            ParameterPropagation(const std::vector<const Declaration*>& declarations, const std::map<const Declaration*, std::string>& bufferTypeNames, const std::set<const Declaration*>& stridedDeclarations, clang::ASTContext& context)
+                :
+                context(context)
+            {
+                for (const auto& declaration : declarations)
+                {
+                    const auto bufferTypeName = bufferTypeNames.find(declaration);
+                    if (bufferTypeName == bufferTypeNames.end()) continue;
+
+                    const clang::QualType type = declaration->decl.getType();
+                    const bool isElementPointer = (declaration->getNestingLevel() == 0 && !type->isRecordType());
+                    const bool providesData = (declaration->getNestingLevel() == 0 && declaration->isContainerDeclaration());
+
+                    const bool isStrided = (stridedDeclarations.find(declaration) != stridedDeclarations.end());
+
+                    entities.insert(std::make_pair(&declaration->decl, Entity{declaration, bufferTypeName->second, type, declaration->elementDataType, declaration->elementDataTypeSpelling, declaration->getNestingLevel() + 1, isElementPointer, providesData, isStrided}));
+                }
+
+                if (entities.empty()) return;
+
+                findCalls();
+                propagate();
+            }
+
+            void modifyFunctions(Rewriter& rewriter, std::set<clang::FileID>& outputFiles)
+            {
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+
+                for (const auto& function : functions)
+                {
+                    const clang::FunctionDecl& definition = *(function.first);
+
+                    for (const clang::FunctionDecl* const redecl : definition.redecls())
+                    {
+                        if (redecl->isImplicit() || redecl->getNumParams() != definition.getNumParams() || redecl->getBeginLoc().isMacroID()) continue;
+
+                        const clang::FileID fileId = sourceManager.getFileID(redecl->getBeginLoc());
+                        clang::RewriteBuffer& rewriteBuffer = rewriter.getEditBuffer(fileId);
+                        outputFiles.insert(fileId);
+
+                        if (function.second.keepOriginal)
+                        {
+                            const bool isDefinition = redecl->doesThisDeclarationHaveABody();
+                            const clang::SourceRange sourceRange = (isDefinition ? redecl->getSourceRange() : getSourceRangeWithClosingCharacter(redecl->getSourceRange(), std::string(";"), context));
+                            const clang::SourceLocation begin = sourceRange.getBegin();
+                            const std::string indent = dumpSourceRangeToString(clang::SourceRange(getBeginOfLine(begin, context), begin), sourceManager);
+                            const std::string original = dumpSourceRangeToString(clang::SourceRange(begin, sourceRange.getEnd().getLocWithOffset(1)), sourceManager);
+
+                            rewriteBuffer.InsertTextBefore(sourceManager.getFileOffset(begin), original + std::string(isDefinition ? "\n\n" : "\n") + indent);
+                        }
+
+                        for (const auto& parameter : function.second.parameterTypeNames)
+                        {
+                            const clang::ParmVarDecl& param = *(redecl->getParamDecl(parameter.first));
+                            const std::string& typeName = parameter.second;
+                            const std::size_t begin = sourceManager.getFileOffset(param.getBeginLoc());
+
+                            if (param.getName().empty())
+                            {
+                                const clang::SourceLocation end = param.getEndLoc();
+                                rewriteBuffer.ReplaceText(begin, sourceManager.getFileOffset(end) + clang::Lexer::MeasureTokenLength(end, sourceManager, context.getLangOpts()) - begin, typeName);
+                            }
+                            else
+                            {
+                                rewriteBuffer.ReplaceText(begin, sourceManager.getFileOffset(param.getLocation()) - begin, typeName + std::string(" "));
+                            }
+                        }
+                    }
+                }
+
+                // buffers are passed themselves: 'foo(v.data(), n)' -> 'foo(v, n)', and element pointers become views: 'foo(&v[i], n)' -> 'foo(v.subrange(i), n)'
+                std::set<const clang::Expr*> modifiedArguments;
+                for (const auto& call : calls)
+                {
+                    const auto function = functions.find(&call.callee);
+                    if (function == functions.end()) continue;
+
+                    for (const auto& parameter : function->second.parameterTypeNames)
+                    {
+                        if (parameter.first >= call.callExpr.getNumArgs()) continue;
+
+                        const clang::Expr* const expr = call.callExpr.getArg(parameter.first)->IgnoreParenImpCasts();
+                        const Argument argument = getArgument(*expr);
+                        if (!argument.entity || argument.replacement == std::string("") || !modifiedArguments.insert(expr).second) continue;
+
+                        const clang::SourceRange sourceRange = expr->getSourceRange();
+                        const clang::FileID fileId = sourceManager.getFileID(sourceRange.getBegin());
+                        const std::size_t begin = sourceManager.getFileOffset(sourceRange.getBegin());
+                        const std::size_t end = sourceManager.getFileOffset(sourceRange.getEnd()) + clang::Lexer::MeasureTokenLength(sourceRange.getEnd(), sourceManager, context.getLangOpts());
+
+                        rewriter.getEditBuffer(fileId).ReplaceText(begin, end - begin, argument.replacement);
+                        outputFiles.insert(fileId);
+                    }
+                }
+            }
+
+            // the transformed declarations are passed to functions that cannot be adapted: they must not be transformed
+            const std::map<const Declaration*, std::string>& getNonAdaptableDeclarations() const
+            {
+                return nonAdaptableDeclarations;
+            }
+
+            // parameters that become buffers (not views), together with the declaration that is passed to them
+            std::map<const clang::ValueDecl*, const Declaration*> getPropagatedParameters() const
+            {
+                std::map<const clang::ValueDecl*, const Declaration*> parameters;
+                for (const auto& entity : entities)
+                {
+                    if (llvm::isa<clang::ParmVarDecl>(entity.first) && !entity.second.isElementPointer)
+                    {
+                        parameters[entity.first] = entity.second.declaration;
+                    }
+                }
+
+                return parameters;
+            }
+
+            void printWarnings() const
+            {
+                for (const auto& warning : warnings)
+                {
+                    std::cerr << warning << std::endl;
+                }
+            }
+
+            void printInfo(const std::string indent = std::string("")) const
+            {
+                std::cout << indent << "PARAMETER PROPAGATION (" << functions.size() << " functions)" << std::endl;
+                for (const auto& function : functions)
+                {
+                    std::cout << indent << "\t* " << function.first->getNameAsString() << (function.second.keepOriginal ? " (original kept)" : "") << std::endl;
+                    for (const auto& parameter : function.second.parameterTypeNames)
+                    {
+                        std::cout << indent << "\t\t+-> " << function.first->getParamDecl(parameter.first)->getNameAsString() << ": " << parameter.second << std::endl;
+                    }
+                }
+            }
+        };
+    }
+}
+
+#endif
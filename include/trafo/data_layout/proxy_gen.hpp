@@ -8,6 +8,8 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
@@ -17,6 +19,8 @@
 #include <clang/AST/ASTConsumer.h>
 #include <clang/AST/ASTContext.h>
 #include <clang/AST/PrettyPrinter.h>
+#include <clang/AST/StmtOpenMP.h>
+#include <clang/Lex/Lexer.h>
 #include <clang/Lex/Preprocessor.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendActions.h>
@@ -25,10 +29,15 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include <misc/ast_helper.hpp>
+#include <misc/environment.hpp>
 #include <misc/matcher.hpp>
 #include <misc/rewriter.hpp>
 #include <misc/string_helper.hpp>
+#include <trafo/data_layout/builtin_proxy.hpp>
 #include <trafo/data_layout/class_meta_data.hpp>
+#include <trafo/data_layout/field_access.hpp>
+#include <trafo/data_layout/loop_tiling.hpp>
+#include <trafo/data_layout/parameter_propagation.hpp>
 #include <trafo/data_layout/variable_declaration.hpp>
 
 #if !defined(TRAFO_NAMESPACE)
@@ -43,12 +52,143 @@ namespace TRAFO_NAMESPACE
     {
         Rewriter rewriter;
         static std::shared_ptr<clang::Preprocessor> preprocessor;
+        // the first pass over all translation units only collects the field accesses (see AnalyzeFieldAccess)
+        const bool isAnalysisPass;
         
         std::vector<const Declaration*> declarations;
+        // containers that are transformed: standard library containers and project-defined ones (CODE_TRAFO_CONTAINERS)
+        const std::vector<ContainerDescriptor> containerDescriptors;
+
+        static std::vector<ContainerDescriptor> getContainerDescriptors()
+        {
+            std::vector<ContainerDescriptor> descriptors;
+            descriptors.push_back(ContainerDescriptor(std::string("vector"), 0, -1, 0));
+            descriptors.push_back(ContainerDescriptor(std::string("array"), 0, 1, -1));
+            descriptors.push_back(ContainerDescriptor(std::string("deque"), 0, -1, 0, true));
+            descriptors.push_back(ContainerDescriptor(std::string("valarray"), 0, -1, 0));
+
+            // 'name:element:extent' with the element type given by template argument 'element' and the extent
+            // given by template argument k ('t<k>', fixed size) or by constructor argument k ('c<k>', dynamic size)
+            const std::string userDefinedContainers = getEnvironmentVariable("CODE_TRAFO_CONTAINERS");
+            for (const auto& entry : splitString(removeSpaces(userDefinedContainers), ','))
+            {
+                const std::vector<std::string> fields = splitString(entry, ':');
+                const bool isValid = (fields.size() == 3 && fields[1].find_first_not_of("0123456789") == std::string::npos &&
+                    fields[2].length() > 1 && (fields[2][0] == 't' || fields[2][0] == 'c') && fields[2].find_first_not_of("0123456789", 1) == std::string::npos);
+
+                if (!isValid)
+                {
+                    std::cerr << "warning: CODE_TRAFO_CONTAINERS: invalid entry '" << entry << "' -> ignored" << std::endl;
+                    continue;
+                }
+
+                const std::size_t elementTypeArgument = std::stoul(fields[1]);
+                const std::int32_t extentArgument = std::stoi(fields[2].substr(1));
+                descriptors.push_back(ContainerDescriptor(fields[0], elementTypeArgument, (fields[2][0] == 't' ? extentArgument : -1), (fields[2][0] == 'c' ? extentArgument : -1)));
+            }
+
+            return descriptors;
+        }
+
+        // 'delete[] p;', 'free(p);' and 'p = nullptr;' statements of transformed heap arrays
+        std::vector<clang::SourceRange> deallocations;
+        // vectors with push_back, emplace_back, resize or reserve calls (and deques growing or shrinking at either end)
+        std::set<const clang::ValueDecl*> growableDeclarations;
+        // vectors with push_back or emplace_back calls inside OpenMP parallel regions
+        std::set<const clang::ValueDecl*> concurrentAppendDeclarations;
+        // vectors of vectors with rows of different lengths
+        std::set<const clang::ValueDecl*> jaggedDeclarations;
+        // buffers, rows and elements referenced through range-based for loop variables and lambda parameters, together with their nesting level
+        // (the nesting level of elements is one more than that of the buffer)
+        std::map<const clang::ValueDecl*, std::pair<const Declaration*, std::uint32_t>> elementRanges;
+        // push_back and emplace_back calls that need to be rewritten
+        std::vector<std::pair<const clang::CXXMemberCallExpr*, const Declaration*>> appendCalls;
+        // functions taking the declarations as arguments get buffer or view parameters: the propagation runs before the declarations
+        // are analyzed, so that the uses of the parameters that become buffers count for the declarations passed to them
+        std::unique_ptr<ParameterPropagation> parameterPropagation;
+        std::map<const clang::ValueDecl*, const Declaration*> propagatedParameters;
+        // declarations inside template instantiations are matched once per instantiation
+        std::map<clang::SourceLocation, std::uint32_t> numInstantiations;
+        // the template code refers to the declarations of the pattern: pattern declaration -> transformed instantiated declaration
+        std::map<const clang::ValueDecl*, const clang::ValueDecl*> templatePatterns;
         std::set<std::string> proxyClassTargetNames;
         std::vector<std::unique_ptr<ClassMetaData>> proxyClassTargets;
         const std::string proxyNamespace = std::string("proxy_internal");
+        // some declarations have standard library element types with built-in proxy types
+        bool usesBuiltinProxies;
         
+        // alignment (in bytes) of the field streams: 0 means no alignment request
+        const std::size_t streamAlignment;
+
+        static std::size_t getStreamAlignment()
+        {
+            const std::size_t alignment = getEnvironmentVariableAsInteger("CODE_TRAFO_ALIGNMENT", 0);
+
+            // the alignment must be a power of two
+            if (alignment & (alignment - 1))
+            {
+                std::cerr << "warning: CODE_TRAFO_ALIGNMENT=" << alignment << " is not a power of two -> ignored" << std::endl;
+                return 0;
+            }
+
+            return alignment;
+        }
+
+        // group fields that are accessed together into AoS records within an SoA-of-clusters layout
+        const bool fieldClustering;
+        // do not allocate streams for fields that are never read
+        const bool deadFieldElimination;
+        // place the streams of inhomogeneous element types in a single allocation
+        const bool packedStreams;
+        // bool fields annotated with 'trafo:bit_packed' are stored with one bit per element
+        const std::string bitStreamTypeName = std::string("XXX_NAMESPACE::bit");
+        // store enum fields in the narrowest integer type that holds all enumerators
+        const bool narrowEnums;
+        // the storage type of a field is determined for every stream layout: invalid annotations are reported once
+        mutable std::set<const clang::FieldDecl*> invalidAnnotationFields;
+        std::unique_ptr<FieldAccessAnalysis> fieldAccessAnalysis;
+
+        // mapping of multi-dimensional indices to storage: 'row_major' (default), 'morton' or 'tiled' (global switch)
+        const std::string indexOrder;
+        // tile extents of tiled buffers, e.g. '8x8x8' (from the outermost to the innermost dimension)
+        const std::string tileExtent;
+        // index order, tile extents and ghost layers are queried for the policies, the strided check and the padding:
+        // they are parsed and validated once per declaration, so that each problem is reported once
+        struct IndexSpace
+        {
+            std::string indexOrder;
+            std::vector<std::size_t> tileExtent;
+            std::vector<std::size_t> haloWidth;
+        };
+        mutable std::map<const Declaration*, IndexSpace> indexSpaces;
+
+        static std::string getIndexOrder()
+        {
+            const std::string order = getEnvironmentVariable("CODE_TRAFO_INDEX_ORDER", std::string("row_major"));
+
+            if (!(order == std::string("row_major") || order == std::string("morton") || order == std::string("tiled")))
+            {
+                std::cerr << "warning: CODE_TRAFO_INDEX_ORDER=" << order << " is not supported -> ignored" << std::endl;
+                return std::string("row_major");
+            }
+
+            return order;
+        }
+
+        // padding of leading dimensions and stream offsets against cache set conflicts (global switch)
+        const bool conflictPadding;
+        const std::size_t cacheLineSize;
+        const std::size_t cacheCriticalStride;
+
+        static std::size_t getCacheCriticalStride()
+        {
+            // addresses that are a multiple of the critical stride apart map to the same cache set
+            const std::size_t cacheSize = getEnvironmentVariableAsInteger("CODE_TRAFO_CACHE_SIZE", 32768);
+            const std::size_t associativity = getEnvironmentVariableAsInteger("CODE_TRAFO_CACHE_ASSOCIATIVITY", 8);
+
+            return (associativity > 0 ? (cacheSize / associativity) : cacheSize);
+        }
+
         bool isThisClassInstantiated(const clang::CXXRecordDecl* const decl)
         {
             using namespace clang::ast_matchers;
@@ -75,1182 +215,3822 @@ namespace TRAFO_NAMESPACE
             return testResult;                
         }
 
-        bool matchDeclarations(const std::vector<std::string>& containerNames, clang::ASTContext& context)
+        // records that are fields of proxy class targets are flattened recursively: they need proxy classes as well
+        void addNestedProxyClassTargetNames(const clang::CXXRecordDecl* const decl)
         {
-            using namespace clang::ast_matchers;
-
-            Matcher matcher;
+            if (!decl || !decl->hasDefinition()) return;
 
-            declarations.clear();
-
-            for (auto containerName : containerNames)
+            for (const auto field : decl->fields())
             {
-                matcher.addMatcher(varDecl(hasType(cxxRecordDecl(hasName(containerName)))).bind("varDecl"),
-                    [&containerNames, &context, this] (const MatchFinder::MatchResult& result) mutable
-                    {
-                        if (const clang::VarDecl* const decl = result.Nodes.getNodeAs<clang::VarDecl>("varDecl"))
-                        {
-                            ContainerDeclaration containerDecl = ContainerDeclaration::make(*decl, context, containerNames);
-                            const clang::Type* const type = containerDecl.elementDataType.getTypePtrOrNull();
-                            const bool isRecordType = (type ? type->isRecordType() : false);
+                const clang::CXXRecordDecl* const nestedDecl = field->getType()->getAsCXXRecordDecl();
 
-                            if (!containerDecl.elementDataType.isNull() && isRecordType)
-                            {
-                                declarations.push_back(new ContainerDeclaration(containerDecl));
-                                proxyClassTargetNames.insert(containerDecl.elementDataTypeName);
-                            }
-                        }
-                    });
-            }
+                // std::array fields are flattened without proxy class
+                if (!nestedDecl || nestedDecl->isInStdNamespace()) continue;
 
-            matcher.addMatcher(varDecl(hasType(constantArrayType())).bind("constArrayDecl"),
-                [&context, this] (const MatchFinder::MatchResult& result) mutable
+                if (proxyClassTargetNames.insert(nestedDecl->getNameAsString()).second)
                 {
-                    if (const clang::VarDecl* const decl = result.Nodes.getNodeAs<clang::VarDecl>("constArrayDecl"))
-                    {
-                        ConstantArrayDeclaration arrayDecl = ConstantArrayDeclaration::make(*decl, context);
-                        const clang::Type* const type = arrayDecl.elementDataType.getTypePtrOrNull();
-                        const bool isRecordType = (type ? type->isRecordType() : false);
+                    addNestedProxyClassTargetNames(nestedDecl);
+                }
+            }
+        }
 
-                        if (!arrayDecl.elementDataType.isNull() && isRecordType)
-                        {
-                            declarations.push_back(new ConstantArrayDeclaration(arrayDecl));
-                            proxyClassTargetNames.insert(arrayDecl.elementDataTypeName);
-                        }
-                    }
-                });
+        // record-typed declarations are transformed with generated proxy classes, declarations of standard library element types with built-in ones
+        void addDeclaration(Declaration* const declaration)
+        {
+            if (isInstantiatedDeclaration(declaration->decl))
+            {
+                ++numInstantiations[declaration->decl.getLocation()];
+            }
 
-            matcher.run(context);
+            const clang::Type* const type = declaration->elementDataType.getTypePtrOrNull();
+            const bool isRecordType = (type ? type->isRecordType() : false);
 
-            return (declarations.size() > 0);
+            if (getBuiltinProxyName(declaration->elementDataType) != std::string("") || (!declaration->elementDataType.isNull() && isRecordType))
+            {
+                declarations.push_back(declaration);
+            }
+            else
+            {
+                delete declaration;
+            }
         }
 
-        bool findProxyClassTargets(clang::ASTContext& context)
+        // declarations inside instantiations of function templates and class templates
+        static bool isInstantiatedDeclaration(const clang::DeclaratorDecl& decl)
         {
-            using namespace clang::ast_matchers;
-
-            Matcher matcher;
-
-            for (auto name : proxyClassTargetNames)
+            if (const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(&decl))
             {
-                // template class declarations
-                matcher.addMatcher(classTemplateDecl(hasName(name)).bind("classTemplateDeclaration"),
-                    [this, &context] (const MatchFinder::MatchResult& result) mutable
-                    {
-                        if (const clang::ClassTemplateDecl* const decl = result.Nodes.getNodeAs<clang::ClassTemplateDecl>("classTemplateDeclaration"))
-                        {
-                            if (decl->isThisDeclarationADefinition()) return;
+                const clang::ClassTemplateSpecializationDecl* const specialization = llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(fieldDecl->getParent());
 
-                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
-                            
-                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
-                                sourceLocationString.find("usr/include") != std::string::npos) return;
+                return (specialization && clang::isTemplateInstantiation(specialization->getSpecializationKind()));
+            }
 
-                            proxyClassTargets.emplace_back(new TemplateClassMetaData(*decl, false));
-                        }
-                    });
-                
-                // template class definitions
-                matcher.addMatcher(classTemplateDecl(hasName(name)).bind("classTemplateDefinition"),
-                    [this, &context] (const MatchFinder::MatchResult& result) mutable
-                    {
-                        if (const clang::ClassTemplateDecl* const decl = result.Nodes.getNodeAs<clang::ClassTemplateDecl>("classTemplateDefinition"))
-                        {
-                            if (!decl->isThisDeclarationADefinition()) return;
+            const clang::FunctionDecl* const function = llvm::dyn_cast_or_null<clang::FunctionDecl>(decl.getParentFunctionOrMethod());
 
-                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
-                            
-                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
-                                sourceLocationString.find("usr/include") != std::string::npos) return;
-                            
-                            for (auto& target : proxyClassTargets)
-                            {
-                                if (target->addDefinition(*(decl->getTemplatedDecl()))) return;
-                            }
-                                       
-                            // not found
-                            proxyClassTargets.emplace_back(new TemplateClassMetaData(*decl, true));
-                            proxyClassTargets.back()->addDefinition(*(decl->getTemplatedDecl()));
-                        }
-                    });
-                
-                // template class partial specialization
-                matcher.addMatcher(classTemplatePartialSpecializationDecl(hasName(name)).bind("classTemplatePartialSpecialization"),
-                    [this, &context] (const MatchFinder::MatchResult& result) mutable
-                    {
-                        if (const clang::ClassTemplatePartialSpecializationDecl* const decl = result.Nodes.getNodeAs<clang::ClassTemplatePartialSpecializationDecl>("classTemplatePartialSpecialization"))
-                        {                         
-                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
-                            
-                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
-                                sourceLocationString.find("usr/include") != std::string::npos) return;
+            return (function && function->getTemplateInstantiationPattern() != nullptr);
+        }
 
-                            const bool isInstantiated = isThisClassInstantiated(decl);
-                            
-                            for (std::size_t i = 0; i < proxyClassTargets.size(); ++i)
-                            {
-                                if (proxyClassTargets[i]->addDefinition(*decl, true, isInstantiated)) return;
-                            }
-                        }
-                    });
-                    
-                // standard C++ classes
-                matcher.addMatcher(cxxRecordDecl(allOf(hasName(name), unless(isTemplateInstantiation()))).bind("c++Class"),
-                    [this, &context] (const MatchFinder::MatchResult& result) mutable
-                    {
-                        if (const clang::CXXRecordDecl* const decl = result.Nodes.getNodeAs<clang::CXXRecordDecl>("c++Class"))
-                        {
-                            const std::string name = decl->getNameAsString();
-                            const bool isDefinition = decl->isThisDeclarationADefinition();
+        // data members of class template instantiations are taken from the pattern, unless their type depends on template parameters
+        static bool hasDependentPattern(const clang::FieldDecl& decl)
+        {
+            const clang::ClassTemplateSpecializationDecl* const specialization = llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(decl.getParent());
+            if (!specialization) return false;
 
-                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
-                            
-                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
-                                sourceLocationString.find("usr/include") != std::string::npos) return;
+            for (const auto field : specialization->getSpecializedTemplate()->getTemplatedDecl()->fields())
+            {
+                if (field->getLocation() == decl.getLocation()) return field->getType()->isDependentType();
+            }
 
-                            for (auto& target : proxyClassTargets)
-                            {
-                                // if it is a specialization of a template class, skip this class definition!
-                                // note: if there are templated classes with that name, they (should) have been found by any previous matcher
-                                if (target->name == name)
-                                {
-                                    if (target->isTemplated()) return;
+            return false;
+        }
 
-                                    if (isDefinition && target->addDefinition(*decl, false)) return;
-                                }
-                            }
+        // the declaration in the template pattern that 'decl' is instantiated from
+        static const clang::ValueDecl* getPatternDeclaration(const clang::DeclaratorDecl& decl)
+        {
+            if (const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(&decl))
+            {
+                const clang::ClassTemplateSpecializationDecl* const specialization = llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(fieldDecl->getParent());
+                if (!specialization) return nullptr;
 
-                            proxyClassTargets.emplace_back(new CXXClassMetaData(*decl, isDefinition));
-                            if (isDefinition)
-                            {
-                                proxyClassTargets.back()->addDefinition(*decl, false);
-                            }
-                        }
-                    });
-            }
+                for (const auto field : specialization->getSpecializedTemplate()->getTemplatedDecl()->fields())
+                {
+                    if (field->getLocation() == decl.getLocation()) return field;
+                }
 
-            matcher.run(context);
+                return nullptr;
+            }
 
-            return (proxyClassTargets.size() > 0);
-        }
-        
-        std::string generateProxyClassDeclaration(const ClassMetaData::Declaration& declaration)
-        {
-            const std::string indent(declaration.indent.value, ' ');
-            const std::string extIndent(declaration.indent.value + declaration.indent.increment, ' ');
-            std::stringstream proxyClassDeclaration;
+            const clang::FunctionDecl* const function = llvm::dyn_cast_or_null<clang::FunctionDecl>(decl.getParentFunctionOrMethod());
+            const clang::FunctionDecl* const pattern = (function ? function->getTemplateInstantiationPattern() : nullptr);
+            if (!pattern) return nullptr;
 
-            proxyClassDeclaration << indent << "namespace " << proxyNamespace << "\n";
-            proxyClassDeclaration << indent << "{\n";
-            if (declaration.templateParameters.size())
+            for (const auto patternDecl : pattern->decls())
             {
-                const clang::SourceManager& sourceManager = declaration.getSourceManager();
-                const std::string parameterList = dumpSourceRangeToString(declaration.templateParameterListSourceRange, sourceManager);
-
-                proxyClassDeclaration << extIndent << parameterList << ">\n";
+                const clang::VarDecl* const varDecl = llvm::dyn_cast<clang::VarDecl>(patternDecl);
+                if (varDecl && varDecl->getLocation() == decl.getLocation()) return varDecl;
             }
-            proxyClassDeclaration << extIndent << (declaration.isStruct ? "struct " : "class ") << declaration.name << "_proxy;\n";
-            proxyClassDeclaration << indent << "}\n\n";
 
-            return proxyClassDeclaration.str();
+            return nullptr;
         }
 
-        std::string generateProxyClassUsingStmt(const ClassMetaData::Definition& definition)
+        // 'v', 'v.begin()', 'v.end()', ... with 'v' having a dependent type -> 'v'
+        static const clang::ValueDecl* getDependentArgumentDeclaration(const clang::Expr& argument)
         {
-            const Indentation insideClassIndent = definition.declaration.indent + 1;
-            const std::string indent(insideClassIndent.value, ' ');
-            std::stringstream usingStmt;
+            const clang::Expr* expr = argument.IgnoreParenImpCasts();
+            if (const clang::CallExpr* const callExpr = llvm::dyn_cast<clang::CallExpr>(expr))
+            {
+                const std::set<std::string> iteratorFunctions = {"begin", "end", "cbegin", "cend", "rbegin", "rend", "crbegin", "crend"};
+                const clang::CXXDependentScopeMemberExpr* const memberExpr = llvm::dyn_cast<clang::CXXDependentScopeMemberExpr>(callExpr->getCallee()->IgnoreParenImpCasts());
+                if (!memberExpr || memberExpr->isImplicitAccess() || iteratorFunctions.find(memberExpr->getMemberNameInfo().getAsString()) == iteratorFunctions.end()) return nullptr;
 
-            usingStmt << indent << "using type = " << definition.name << definition.templateParameterString << ";\n\n";
-            usingStmt << indent << "using proxy_type = typename " << definition.declaration.namespaceString << proxyNamespace << "::" << definition.name << "_proxy";
-            usingStmt << definition.templateParameterString << ";\n";
+                expr = memberExpr->getBase()->IgnoreParenImpCasts();
+            }
 
-            return usingStmt.str();
+            return getReferencedDeclaration(*expr);
         }
 
-        std::string generateConstructorInitializerList(const ClassMetaData::Definition& definition, const std::string rhs = std::string("rhs"), const Indentation indentation = Indentation(0))
+        static clang::TypeLoc getUnqualifiedTypeLoc(clang::TypeLoc typeLoc)
         {
-            const std::string indent(indentation.value, ' ');
-
-            if (const std::uint32_t numInitializers = definition.fields.size())
+            while (true)
             {
-                std::stringstream initializerList;
-
-                initializerList << indent << ":\n";
-                for (std::uint32_t i = 0; i < numInitializers; ++i)
+                if (const clang::QualifiedTypeLoc qualifiedTypeLoc = typeLoc.getAs<clang::QualifiedTypeLoc>())
                 {
-                    const std::string fieldName = definition.fields[i].name;
-                    initializerList << indent << fieldName << "(" << rhs << "." << fieldName;
-                    initializerList << ((i + 1) < numInitializers ? "),\n" : ")\n");
+                    typeLoc = qualifiedTypeLoc.getUnqualifiedLoc();
+                }
+                else if (const clang::ElaboratedTypeLoc elaboratedTypeLoc = typeLoc.getAs<clang::ElaboratedTypeLoc>())
+                {
+                    typeLoc = elaboratedTypeLoc.getNamedTypeLoc();
+                }
+                else
+                {
+                    return typeLoc;
                 }
-
-                return initializerList.str();
             }
-            
-            return std::string("");
         }
 
-        std::string generateConstructorClassFromProxyClass(const ClassMetaData::Definition& definition)
+        // element type as written in the declaration, e.g. 'fw::vec<T, 3>' in 'std::vector<fw::vec<T, 3>> tmp(n);' (empty if it cannot be determined)
+        std::string getWrittenElementTypeName(const Declaration& declaration, clang::ASTContext& context) const
         {
-            const Indentation insideClassIndent = definition.declaration.indent + 1;
-            const std::string indent(insideClassIndent.value, ' ');
-            std::stringstream constructorDefinition;
-
-            constructorDefinition << indent;
+            const clang::TypeSourceInfo* const typeSourceInfo = declaration.decl.getTypeSourceInfo();
+            if (!typeSourceInfo) return std::string("");
 
-            if (definition.hasCopyConstructor)
+            clang::TypeLoc typeLoc = typeSourceInfo->getTypeLoc();
+            std::uint32_t level = 0;
+            while (level <= declaration.getNestingLevel())
             {
-                const auto& constructor = definition.constructors[definition.indexCopyConstructor];
-                const clang::ParmVarDecl* const parameter = constructor.decl.getParamDecl(0); // never nullptr
+                typeLoc = getUnqualifiedTypeLoc(typeLoc);
 
-                if (constructor.isTemplatedConstructor)
-                {
-                    constructorDefinition << dumpSourceRangeToString(constructor.templateSignatureSourceRange, definition.getSourceManager());
-                }
-                constructorDefinition << definition.name << "(const " << proxyNamespace << "::" << definition.name << "_proxy";
-                if (constructor.isTemplatedConstructor)
+                if (const clang::PointerTypeLoc pointerTypeLoc = typeLoc.getAs<clang::PointerTypeLoc>())
                 {
-                    const internal::ClassMetaData::FunctionArgument argument(*parameter, &definition);
-                    constructorDefinition << argument.templateParameters;
+                    typeLoc = pointerTypeLoc.getPointeeLoc();
+                    ++level;
+                    continue;
                 }
-                constructorDefinition << "& ";
-                
-                // dump the definition of the copy constructor starting at the parameter name
-                const clang::SourceRange everythingFromParmVarDeclName(parameter->getEndLoc(), constructor.decl.getEndLoc());
-                constructorDefinition << dumpSourceRangeToString(everythingFromParmVarDeclName, definition.getSourceManager());
-                if (constructor.decl.hasBody())
+
+                if (const clang::ArrayTypeLoc arrayTypeLoc = typeLoc.getAs<clang::ArrayTypeLoc>())
                 {
-                    constructorDefinition << "}";
+                    typeLoc = arrayTypeLoc.getElementLoc();
+                    ++level;
+                    continue;
                 }
+
+                const clang::TemplateSpecializationTypeLoc tsTypeLoc = typeLoc.getAs<clang::TemplateSpecializationTypeLoc>();
+                const clang::TemplateDecl* const templateDecl = (tsTypeLoc ? tsTypeLoc.getTypePtr()->getTemplateName().getAsTemplateDecl() : nullptr);
+                if (!templateDecl) return std::string("");
+
+                // std::unique_ptr<T[]>: the array is the template argument
+                const bool isSmartPointer = (templateDecl->getNameAsString() == std::string("unique_ptr"));
+                const ContainerDescriptor* const descriptor = ContainerDescriptor::find(containerDescriptors, templateDecl->getNameAsString());
+                if (!isSmartPointer && !descriptor) return std::string("");
+
+                const std::size_t argument = (isSmartPointer ? 0 : descriptor->elementTypeArgument);
+                if (argument >= tsTypeLoc.getNumArgs()) return std::string("");
+
+                const clang::TypeSourceInfo* const argumentTypeSourceInfo = tsTypeLoc.getArgLoc(argument).getTypeSourceInfo();
+                if (!argumentTypeSourceInfo) return std::string("");
+
+                typeLoc = argumentTypeSourceInfo->getTypeLoc();
+                if (!isSmartPointer) ++level;
             }
-            else
-            {
-                constructorDefinition << definition.name << "(const " << proxyNamespace << "::" << definition.name << "_proxy& other)\n";
-                constructorDefinition << generateConstructorInitializerList(definition, std::string("other"), insideClassIndent + 1);
-                constructorDefinition << indent << "{ ; }";
-            }
-            constructorDefinition << "\n";
 
-            return constructorDefinition.str();
+            return dumpTokenRangeToString(typeLoc.getSourceRange(), context.getSourceManager());
         }
 
-        void modifyMethodSignature(const ClassMetaData::Definition& definition, const ClassMetaData::Function& method, Rewriter& rewriter, const std::string proxyNamespace, const std::string targetNamespace, const bool returnProxyType = false)
+        // declarations inside templates are matched once per instantiation: the declaration is transformed if it is transformable in all instantiations
+        // and its extents do not depend on the instantiation. the buffer type uses the element type as written, so that it stays dependent.
+        // the template code refers to the pattern declaration: range-based for loops over it are rewritten through the pattern, calls taking it
+        // (or its iterators) as arguments are unresolved and cannot be adapted
+        void mergeTemplateInstantiations(clang::ASTContext& context)
         {
-            clang::ASTContext& context = definition.declaration.getASTContext();
-            const clang::SourceManager& sourceManager = definition.declaration.getSourceManager();
-            const clang::FileID fileId = definition.declaration.fileId;
-            const Indentation insideClassIndent = definition.declaration.indent + 1;
-            const std::string indent(insideClassIndent.value, ' ');
-            const std::string extIndent((insideClassIndent + 1).value, ' ');
-            const std::string proxyTypeName = proxyNamespace + method.className + std::string("_proxy");
-            const std::string targetTypeName = targetNamespace + method.className;
+            using namespace clang::ast_matchers;
 
-            if (method.isMacroExpansion)
+            std::vector<const clang::CallExpr*> patternCalls;
+
+            Matcher matcher;
+            matcher.addMatcher(callExpr(unless(isExpansionInSystemHeader()), unless(isInTemplateInstantiation()), unless(cxxOperatorCallExpr())).bind("call"),
+                [&patternCalls] (const MatchFinder::MatchResult& result) mutable
+                {
+                    const clang::CallExpr* const callExpr = result.Nodes.getNodeAs<clang::CallExpr>("call");
+                    if (callExpr && callExpr->isTypeDependent()) patternCalls.push_back(callExpr);
+                });
+            matcher.run(context);
+
+            std::set<const clang::ValueDecl*> patternArguments;
+            for (const auto callExpr : patternCalls)
             {
-                std::string macroString = dumpSourceRangeToString(getExpansionSourceRange(method.sourceRange, context), sourceManager);                            
-                std::string proxyMacroString = macroString;
-                if (findAndReplace(macroString, method.className, targetTypeName, true, true))
+                for (const auto argument : callExpr->arguments())
                 {
-                    rewriter.replace(getExpansionSourceRange(method.sourceRange, context), macroString);
+                    const clang::ValueDecl* const decl = getDependentArgumentDeclaration(*argument);
+                    if (decl) patternArguments.insert(decl);
                 }
-                if (findAndReplace(proxyMacroString, method.className, proxyTypeName, true, true))
+            }
+
+            templatePatterns.clear();
+
+            std::set<clang::SourceLocation> patternLocations;
+            std::map<clang::SourceLocation, std::vector<const Declaration*>> instantiations;
+
+            for (const auto& declaration : declarations)
+            {
+                if (isInstantiatedDeclaration(declaration->decl))
                 {
-                    rewriter.insert(getNextLine(getExpansionSourceLocation(method.sourceRange.getEnd(), context), context), indent + proxyMacroString + std::string("\n"));
+                    instantiations[declaration->decl.getLocation()].push_back(declaration);
                 }
-                
-                // adapt return type
-                if (returnProxyType && method.returnsClassTypeReference)
+                else
                 {
-                    const clang::SourceLocation beginLoc = getSpellingSourceLocation(method.returnTypeSourceRange.getBegin(), context);
-                    const clang::SourceLocation endLoc = getSpellingSourceLocation(method.bodySourceRange.getBegin(), context).getLocWithOffset(-1);
-                    std::string selection = dumpSourceRangeToString({beginLoc, endLoc}, sourceManager);
-                    findAndReplace(selection, method.className, proxyTypeName, true, true);
-
-                    rewriter.replace({beginLoc, endLoc}, selection);
+                    patternLocations.insert(declaration->decl.getLocation());
                 }
             }
-            else
-            {
-                // duplicate the original function definition and insert it only if we have to change argument types in the orignal definition
-                // NOTE 1: this must not be the case if the class-type arguments have default values!
-                const std::string originalFunctionDefinition = dumpSourceRangeToString(method.extendedSourceRange, sourceManager);
-                bool insertOriginalDefinition = false;
 
-                // create new function
-                std::stringstream functionSignature;
-                bool insertNewDefinition = false;
+            std::set<const Declaration*> removedDeclarations;
+            for (const auto& instantiation : instantiations)
+            {
+                const std::vector<const Declaration*>& group = instantiation.second;
+                Declaration& declaration = *const_cast<Declaration*>(group[0]);
 
-                if (method.returnsClassType && returnProxyType)
+                // declarations with non-dependent types are transformed through the template pattern
+                if (patternLocations.find(instantiation.first) != patternLocations.end())
                 {
-                    std::string tmp = method.signatureString[0];
-                    findAndReplace(tmp, method.className, proxyTypeName, true, true);
-                    functionSignature << tmp << "(";
+                    removedDeclarations.insert(group.begin(), group.end());
+                    continue;
                 }
-                else
+
+                bool isTransformable = (group.size() == numInstantiations[instantiation.first]);
+                if (!isTransformable)
                 {
-                    functionSignature << method.signatureString[0] << "(";
+                    std::cerr << "warning: " << declaration.decl.getNameAsString() << " is transformable in " << group.size() << " of " << numInstantiations[instantiation.first] << " template instantiations -> not transformed" << std::endl;
                 }
 
-                for (std::uint32_t i = 0; i < method.arguments.size(); ++i)
+                for (const auto& other : group)
                 {
-                    const auto& argument = method.arguments[i];
-
-                    if (argument.isClassType)
+                    if (isTransformable && other->getExtentString() != declaration.getExtentString())
                     {
-                        std::string targetArgumentTypeName = argument.elementTypeName;
-                        std::string proxyArgumentTypeName = targetArgumentTypeName;
-                        findAndReplace(targetArgumentTypeName, method.className, targetTypeName, true, true);
-                        findAndReplace(proxyArgumentTypeName, method.className, proxyTypeName, true, true);
-                        
-                        std::string argumentStringPostfix = (method.isFunctionTemplate ? argument.templateParameters : std::string("")) +
-                            std::string(argument.isRReference ? "&&" : "") + 
-                            std::string(argument.isLReference ? "&" : "") + 
-                            std::string(argument.isPointer ? "* " : " ") + 
-                            argument.name;
-                        std::string targetArgumentString = (argument.isConst ? "const " : "") + targetArgumentTypeName + argumentStringPostfix;
-                        std::string proxyArgumentString = (argument.isConst ? "const " : "") + proxyArgumentTypeName + argumentStringPostfix;
+                        std::cerr << "warning: the extents of " << declaration.decl.getNameAsString() << " depend on the template instantiation -> not transformed" << std::endl;
+                        isTransformable = false;
+                    }
+                }
 
-                        if (argument.decl.hasDefaultArg())
-                        {
-                            std::string originalArgumentString = dumpSourceRangeToString(method.signature[i + 1], sourceManager);
+                const std::string elementDataTypeSpelling = getWrittenElementTypeName(declaration, context);
+                if (isTransformable && elementDataTypeSpelling == std::string(""))
+                {
+                    std::cerr << "warning: unable to determine the written element type of " << declaration.decl.getNameAsString() << " in " << declaration.sourceRange.printToString(context.getSourceManager()) << " -> not transformed" << std::endl;
+                    isTransformable = false;
+                }
 
-                            rewriter.replace(argument.sourceRange, targetArgumentString + std::string(" ") + originalArgumentString.substr(originalArgumentString.rfind('=')));
-                            insertNewDefinition = true;
-                        }
-                        else
-                        {
-                            // 1. replace argument by proxy argument in original function
-                            rewriter.replace(argument.sourceRange, proxyArgumentString);
-                            insertOriginalDefinition = true;
-                        }
+                const clang::ValueDecl* const patternDecl = (isTransformable ? getPatternDeclaration(declaration.decl) : nullptr);
+                if (isTransformable && !patternDecl)
+                {
+                    std::cerr << "warning: unable to find the template pattern of " << declaration.decl.getNameAsString() << " in " << declaration.sourceRange.printToString(context.getSourceManager()) << " -> not transformed" << std::endl;
+                    isTransformable = false;
+                }
 
-                        // 2. create proxy argument in new function
-                        functionSignature << (i > 0 ? ", " : "") << proxyArgumentString;
-                    }
-                    else
-                    {
-                        functionSignature << (i > 0 ? ", " : "") << dumpSourceRangeToString(method.signature[i + 1], sourceManager);
-                    }
+                if (isTransformable && patternArguments.find(patternDecl) != patternArguments.end())
+                {
+                    std::cerr << "warning: " << declaration.decl.getNameAsString() << " is passed to a function inside a template -> not transformed" << std::endl;
+                    isTransformable = false;
+                }
 
-                    if ((i + 1) ==  method.arguments.size())
-                    {
-                        functionSignature << (method.isConst ? ") const\n" : ")\n");
-                    }
+                if (isTransformable)
+                {
+                    declaration.elementDataTypeSpelling = elementDataTypeSpelling;
+                    templatePatterns[patternDecl] = &declaration.decl;
+                    removedDeclarations.insert(group.begin() + 1, group.end());
                 }
-                
-                if (insertNewDefinition)
+                else
                 {
-                    rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), std::string("\n") + indent + functionSignature.str());
-                    rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), indent + dumpSourceRangeToString(method.extendedBodySourceRange, sourceManager));
+                    removedDeclarations.insert(group.begin(), group.end());
                 }
+            }
 
-                if (insertOriginalDefinition)
+            for (auto it = declarations.begin(); it != declarations.end(); )
+            {
+                if (removedDeclarations.find(*it) != removedDeclarations.end())
                 {
-                    if (returnProxyType)
-                    {
-                        if (method.returnsClassTypeReference)
-                        {
-                            std::string tmp = dumpSourceRangeToString(method.signatureSourceRange, sourceManager);
-                            findAndReplace(tmp, method.className, proxyTypeName, false, true);
-                            rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), std::string("\n") + indent + tmp);
-                            rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), dumpSourceRangeToString(method.extendedBodySourceRange, sourceManager));
-                        }
-                    }
-                    else
-                    {
-                        rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), std::string("\n") + indent + originalFunctionDefinition);
-                    }
+                    delete *it;
+                    it = declarations.erase(it);
+                }
+                else
+                {
+                    ++it;
                 }
             }
         }
 
+        // is 'stmt' a statement of its own (and not part of an expression or condition)?
+        static bool isFullStatement(const clang::Stmt& stmt, clang::ASTContext& context)
+        {
+            const clang::Stmt* const parent = getParentIgnoringImplicitCode(stmt, context);
 
-        void modifyOriginalSourceCode(const std::unique_ptr<ClassMetaData>& candidate, Rewriter& rewriter)
+            return (parent && llvm::isa<clang::CompoundStmt>(parent));
+        }
+
+        // local declaration that is a statement of its own: 'T* p = new T[n]();'
+        static bool isDeclarationStatement(const clang::DeclaratorDecl& decl, clang::ASTContext& context)
         {
-            if (!candidate.get()) return;
+            const clang::VarDecl* const variable = llvm::dyn_cast<clang::VarDecl>(&decl);
+            if (!variable || !variable->isLocalVarDecl()) return false;
 
-            const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
-            clang::ASTContext& context = declaration.getASTContext();
-            const clang::SourceManager& sourceManager = declaration.getSourceManager();
-            const clang::FileID fileId = declaration.fileId;
+            const auto parents = context.getParents(decl);
+            const clang::DeclStmt* const declStmt = (parents.empty() ? nullptr : parents[0].get<clang::DeclStmt>());
 
-            // insert proxy class forward declaration
-            rewriter.insert(getBeginOfLine(declaration.sourceRange.getBegin(), context), generateProxyClassDeclaration(declaration));
-            
-            // add constructors with proxy class arguments
-            const std::vector<ClassMetaData::Definition>& definitions = candidate->getDefinitions();
-            for (const auto& definition : definitions)
+            return (declStmt && declStmt->isSingleDecl() && isFullStatement(*declStmt, context));
+        }
+
+        // const fields delete the assignment of the original type and of its proxy type
+        static bool isAssignable(const clang::QualType& type, clang::ASTContext& context)
+        {
+            const clang::CXXRecordDecl* const recordDecl = type->getAsCXXRecordDecl();
+            if (!recordDecl || !recordDecl->hasDefinition()) return !type.isConstQualified();
+
+            for (const auto field : recordDecl->fields())
             {
-                const Indentation insideClassIndent = definition.declaration.indent + 1;
-                const std::string indent(insideClassIndent.value, ' ');
-                const std::string extIndent((insideClassIndent + 1).value, ' ');
+                if (context.getBaseElementType(field->getType()).isConstQualified() || field->getType()->isReferenceType()) return false;
+            }
 
-                // in case of a C++ class, there must be at least one public access specifier
-                // as we require proxy class candidates have at least one public field!
-                clang::SourceLocation sourceLocation;
+            return true;
+        }
 
-                if (definition.indexPublicAccessSpecifiers.size() > 0)
-                {
-                    sourceLocation = definition.accessSpecifiers[definition.indexPublicAccessSpecifiers[0]].scopeBegin;
+        // heap arrays become buffers: they can be indexed, deallocated and passed to functions defined in this translation unit, but any other use (e.g. pointer arithmetic) prevents the transformation
+        void checkHeapArrayDeclarations(clang::ASTContext& context)
+        {
+            using namespace clang::ast_matchers;
 
-                }
-                else if (definition.declaration.isStruct)
+            std::map<const clang::ValueDecl*, std::vector<clang::SourceRange>> heapArrayDeallocations;
+            std::set<const clang::ValueDecl*> rejectedDeclarations;
+
+            // buffers do not zero or value initialize their elements: the initialization is emitted as a statement after the declaration
+            // (see generateBufferDeclaration), which assigns to all elements
+            for (auto it = declarations.begin(); it != declarations.end(); )
+            {
+                const HeapArrayDeclaration* const declaration = ((*it)->isHeapArrayDeclaration() ? static_cast<const HeapArrayDeclaration*>(*it) : nullptr);
+                if (!declaration || !declaration->isInitializingAllocation)
                 {
-                    sourceLocation = definition.innerSourceRange.getBegin();
+                    ++it;
+                    continue;
                 }
 
-                // insert using statement into class definition
-                rewriter.insert(sourceLocation, generateProxyClassUsingStmt(definition));
-                
-                // insert constructor
-                if (definition.hasCopyConstructor)
+                std::string reason("");
+                if (declaration->hasElementInitializers)
                 {
-                    sourceLocation = getNextLine(definition.constructors[definition.indexCopyConstructor].sourceRange.getEnd(), context);
+                    reason = std::string("its elements have initializers of their own");
                 }
-                else if (definition.indexPublicConstructors.size() > 0)
+                else if (!isDeclarationStatement(declaration->decl, context))
                 {
-                    sourceLocation = getNextLine(definition.constructors[definition.indexPublicConstructors.back()].sourceRange.getEnd(), context);
+                    reason = std::string("the initialization cannot follow the declaration");
+                }
+                else if (!isAssignable(declaration->elementDataType, context))
+                {
+                    reason = std::string("its elements are not assignable");
                 }
-                rewriter.insert(sourceLocation, generateConstructorClassFromProxyClass(definition));
 
-                // insert methods that have the class type as argument type
-                for (const auto& method : definition.cxxMethods)
+                if (reason == std::string(""))
                 {
-                    if (method.hasClassTypeArguments)
-                    { 
-                        modifyMethodSignature(definition, method, rewriter, proxyNamespace + std::string("::"), std::string(""));
-                    }
+                    ++it;
+                    continue;
                 }
+
+                std::cerr << "warning: heap array " << declaration->decl.getNameAsString() << " is initialized by its allocation (" << declaration->allocation << ") and " << reason << " -> not transformed" << std::endl;
+                delete *it;
+                it = declarations.erase(it);
             }
-            
-            // insert include line outside the outermost namespace or after the last class definition if there is no namespace
-            std::stringstream includeLine;
-            includeLine << "\n#include \"autogen_" << candidate->name << "_proxy.hpp\"\n\n";
-            rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), includeLine.str());
 
-            // insert type traits
+            for (const auto& declaration : declarations)
             {
-                const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
-                
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), std::string("#include <common/traits.hpp>\n\n"));    
-                
-                const Indentation Indent = Indentation(declaration.indent.increment, declaration.indent.increment);
-                const std::string indent(Indent.value, ' ');
-                const Indentation ExtIndent = Indent + 1;
-                const std::string extIndent(ExtIndent.value, ' ');
-                const Indentation ExtExtIndent = ExtIndent + 1;
-                const std::string extExtIndent(ExtExtIndent.value, ' ');
-                std::string namespaceName;
-                for (const auto& thisNamespace : declaration.namespaces)
+                if (declaration->isHeapArrayDeclaration())
                 {
-                    namespaceName += (thisNamespace.name + std::string("::"));
+                    heapArrayDeallocations[&declaration->decl];
                 }
+            }
 
-                
-                std::stringstream typeTraitsStream_1;
-                typeTraitsStream_1 << "namespace XXX_NAMESPACE\n{\n";
-                typeTraitsStream_1 << indent << "namespace internal\n";
-                typeTraitsStream_1 << indent << "{\n";
-                if (candidate->isTemplated())
+            if (heapArrayDeallocations.empty()) return;
+
+            Matcher matcher;
+            matcher.addMatcher(declRefExpr().bind("heapArrayRef"),
+                [&heapArrayDeallocations, &rejectedDeclarations, &context] (const MatchFinder::MatchResult& result) mutable
                 {
-                    typeTraitsStream_1 << extIndent << "template " << declaration.templateParameterDeclString << "\n";
-                }
-                typeTraitsStream_1 << extIndent << "struct provides_proxy_type<";
+                    const clang::DeclRefExpr* const declRefExpr = result.Nodes.getNodeAs<clang::DeclRefExpr>("heapArrayRef");
+                    if (!declRefExpr) return;
 
-                std::stringstream typeTraitsStream_2;
-                typeTraitsStream_2 << extIndent << "{\n";
-                typeTraitsStream_2 << extExtIndent << "static constexpr bool value = true;\n";
-                typeTraitsStream_2 << extIndent << "};\n";
-                typeTraitsStream_2 << indent << "}\n";
-                typeTraitsStream_2 << "}\n";
+                    const auto it = heapArrayDeallocations.find(declRefExpr->getDecl());
+                    if (it == heapArrayDeallocations.end()) return;
 
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_1.str());
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), namespaceName + declaration.name + declaration.templateParameterString + std::string(">\n"));
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_2.str() + std::string("\n"));
+                    const clang::Stmt* const parent = getParentIgnoringImplicitCode(*declRefExpr, context);
+                    if (!parent)
+                    {
+                        rejectedDeclarations.insert(it->first);
+                        return;
+                    }
 
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_1.str());
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), std::string("const ") + namespaceName + declaration.name + declaration.templateParameterString + std::string(">\n"));
-                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_2.str());
-            }
+                    // p[i]
+                    if (const clang::ArraySubscriptExpr* const subscriptExpr = llvm::dyn_cast<clang::ArraySubscriptExpr>(parent))
+                    {
+                        if (subscriptExpr->getBase()->IgnoreParenImpCasts() == declRefExpr) return;
+                    }
+                    else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(parent))
+                    {
+                        if (operatorCallExpr->getOperator() == clang::OO_Subscript && operatorCallExpr->getArg(0)->IgnoreParenImpCasts() == declRefExpr) return;
+                    }
+                    // delete[] p;
+                    else if (const clang::CXXDeleteExpr* const deleteExpr = llvm::dyn_cast<clang::CXXDeleteExpr>(parent))
+                    {
+                        if (deleteExpr->isArrayForm() && isFullStatement(*deleteExpr, context))
+                        {
+                            it->second.push_back(deleteExpr->getSourceRange());
+                            return;
+                        }
+                    }
+                    // free(p);
+                    else if (const clang::CallExpr* const callExpr = llvm::dyn_cast<clang::CallExpr>(parent))
+                    {
+                        const clang::FunctionDecl* const callee = callExpr->getDirectCallee();
+                        if (callee && callee->getNameAsString() == std::string("free") && isFullStatement(*callExpr, context))
+                        {
+                            it->second.push_back(callExpr->getSourceRange());
+                            return;
+                        }
 
-        }
+                        // foo(p, n): the parameter becomes a buffer as well, or the heap array is not transformed if it cannot (see propagateParameters)
+                        if (callee && callee->isDefined() && !llvm::isa<clang::CXXOperatorCallExpr>(callExpr) && callExpr->getCallee()->IgnoreParenImpCasts() != declRefExpr) return;
+                    }
+                    // p = nullptr;
+                    else if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast<clang::BinaryOperator>(parent))
+                    {
+                        if (binaryOperator->getOpcode() == clang::BO_Assign && binaryOperator->getLHS()->IgnoreParenImpCasts() == declRefExpr &&
+                            binaryOperator->getRHS()->isNullPointerConstant(context, clang::Expr::NPC_ValueDependentIsNotNull) && isFullStatement(*binaryOperator, context))
+                        {
+                            it->second.push_back(binaryOperator->getSourceRange());
+                            return;
+                        }
+                    }
 
-        std::string generateProxyClassConstructor(const ClassMetaData::Definition& definition)
-        {
-            std::stringstream constructor;
-            const Indentation Indent = definition.declaration.indent + 1;
-            const std::string indent(Indent.value, ' ');
-            const Indentation ExtIndent = definition.declaration.indent + 2;
-            const std::string extIndent(ExtIndent.value, ' ');
-
-            constructor << definition.name << "_proxy(base_pointer base)\n" << extIndent << ":\n";
+                    rejectedDeclarations.insert(it->first);
+                });
+            matcher.run(context);
 
-            if (definition.isHomogeneous)
+            for (auto it = declarations.begin(); it != declarations.end(); )
             {
-                std::uint32_t fieldId = 0;
-                for (const auto& field : definition.fields)
+                const auto deallocation = heapArrayDeallocations.find(&((*it)->decl));
+
+                if (deallocation == heapArrayDeallocations.end())
                 {
-                    constructor << extIndent << field.name << "(base.ptr[" << fieldId << " * base.n_0])" << ((fieldId + 1) < definition.fields.size() ? ",\n" : "\n");
-                    ++fieldId;
+                    ++it;
                 }
-            }
-            else
-            {
-                std::uint32_t fieldId = 0;
-                for (const auto& field : definition.fields)
+                else if (rejectedDeclarations.find(deallocation->first) != rejectedDeclarations.end())
                 {
-                    constructor << extIndent << field.name << "(*(std::get<" << fieldId << ">(base.ptr)))" << ((fieldId + 1) < definition.fields.size() ? ",\n" : "\n");
-                    ++fieldId;
+                    std::cerr << "warning: heap array " << (*it)->decl.getNameAsString() << " is used other than for indexing and deallocation -> not transformed" << std::endl;
+                    delete *it;
+                    it = declarations.erase(it);
+                }
+                else
+                {
+                    deallocations.insert(deallocations.end(), deallocation->second.begin(), deallocation->second.end());
+                    ++it;
                 }
             }
-            constructor << indent << "{}\n";
-            
-            return constructor.str();
         }
 
-        std::string generateProxyClassTupleConstructor(const ClassMetaData::Definition& definition)
+        static bool isInsideParallelRegion(const clang::Stmt& stmt, clang::ASTContext& context)
         {
-            std::stringstream constructor;
-            const Indentation Indent = definition.declaration.indent + 1;
-            const std::string indent(Indent.value, ' ');
-            const Indentation ExtIndent = definition.declaration.indent + 2;
-            const std::string extIndent(ExtIndent.value, ' ');
-
-            constructor << definition.name << "_proxy(" << "std::tuple<";
+            auto parents = context.getParents(stmt);
 
-            std::uint32_t fieldId = 0;
-            for (const auto& field : definition.fields)
-            {
-                constructor << (fieldId == 0 ? "" : ", ") << field.elementTypeName << "&";
-                ++fieldId;
-            }
-            constructor << "> obj)\n" << extIndent << ":\n";
-            fieldId = 0;
-            for (const auto& field : definition.fields)
+            while (!parents.empty())
             {
-                constructor << extIndent << field.name << "(std::get<" << fieldId << ">(obj))" << ((fieldId + 1) < definition.fields.size() ? ",\n" : "\n");
-                ++fieldId;
+                if (const clang::OMPExecutableDirective* const directive = parents[0].get<clang::OMPExecutableDirective>())
+                {
+                    if (clang::isOpenMPParallelDirective(directive->getDirectiveKind())) return true;
+                }
+
+                // the region ends at function boundaries
+                if (parents[0].get<clang::FunctionDecl>() || parents[0].get<clang::LambdaExpr>()) return false;
+
+                parents = context.getParents(parents[0]);
             }
-            constructor << indent << "{}\n";
 
-            return constructor.str();
+            return false;
         }
 
-        void generateProxyClassDefinition(const std::unique_ptr<ClassMetaData>& candidate, Rewriter& rewriter, const std::string header = std::string(""))
+        bool isJaggedDeclaration(const Declaration& declaration) const
         {
-            if (!candidate.get()) return;
-
-            // some file related locations
-            const clang::SourceManager& sourceManager = candidate->sourceManager;
-            clang::ASTContext& context = candidate->context;
-            const clang::FileID fileId = candidate->getDeclaration().fileId;
-            const clang::SourceLocation fileStart = sourceManager.getLocForStartOfFile(fileId);
-            const clang::SourceLocation fileEnd = sourceManager.getLocForEndOfFile(fileId);
+            return (jaggedDeclarations.find(&declaration.decl) != jaggedDeclarations.end());
+        }
 
-            // insert iterator class forward declaration (top level namespace) and include lines
-            {
-                const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
-                const clang::SourceLocation insertLocation = (declaration.namespaces.size() > 0 ? declaration.namespaces[0].sourceRange.getBegin() : declaration.sourceRange.getBegin());
-                
-                rewriter.insert(insertLocation, std::string("#include <common/memory.hpp>\n"));
-                rewriter.insert(insertLocation, std::string("#include <common/data_layout.hpp>\n\n"));
-                
-                const Indentation Indent = Indentation(declaration.indent.increment, declaration.indent.increment);
-                const std::string indent(Indent.value, ' ');
-                const Indentation ExtIndent = Indent + 1;
-                const std::string extIndent(ExtIndent.value, ' ');
+        static bool isVectorOfVectors(const Declaration& declaration)
+        {
+            if (declaration.getNestingLevel() != 1 || !declaration.isContainerDeclaration()) return false;
 
-                std::stringstream iteratorForwardDeclStream;
-                iteratorForwardDeclStream << "namespace XXX_NAMESPACE\n{\n";
-                iteratorForwardDeclStream << indent << "namespace internal \n";
-                iteratorForwardDeclStream << indent << "{\n";
-                iteratorForwardDeclStream << extIndent << "template <typename P, typename R>\n";
-                iteratorForwardDeclStream << extIndent << "class iterator;\n";
-                iteratorForwardDeclStream << indent << "}\n";
-                iteratorForwardDeclStream << "}\n\n";
-                rewriter.insert(insertLocation, iteratorForwardDeclStream.str());
+            const clang::ClassTemplateSpecializationDecl* const outerDecl = llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(declaration.decl.getType()->getAsCXXRecordDecl());
+            if (!outerDecl || outerDecl->getNameAsString() != std::string("vector")) return false;
 
-                std::stringstream accessorForwardDeclStream;
-                accessorForwardDeclStream << "namespace XXX_NAMESPACE\n{\n";
-                accessorForwardDeclStream << indent << "namespace internal \n";
-                accessorForwardDeclStream << indent << "{\n";
-                accessorForwardDeclStream << extIndent << "template <typename X, std::size_t N, std::size_t D, XXX_NAMESPACE::data_layout L>\n";
-                accessorForwardDeclStream << extIndent << "class accessor;\n";
-                accessorForwardDeclStream << indent << "}\n";
-                accessorForwardDeclStream << "}\n\n";
-                rewriter.insert(insertLocation, accessorForwardDeclStream.str());
-            }
+            const clang::CXXRecordDecl* const innerDecl = outerDecl->getTemplateArgs().get(0).getAsType()->getAsCXXRecordDecl();
 
+            return (innerDecl && innerDecl->getNameAsString() == std::string("vector"));
+        }
 
-            // declarations for which proxy equivalents need to be generated
-            const std::uint32_t numRelevantSourceRanges = candidate->relevantSourceRanges.size(); // is at least 1
-            ClassMetaData::SourceRangeSet::const_iterator sourceRange = candidate->relevantSourceRanges.cbegin();
+        // in-class initializer and the written initializers of the constructor definitions: constructors that do not initialize
+        // the data member (and there is no in-class initializer) contribute a null initializer
+        static std::vector<const clang::Expr*> getMemberInitializers(const clang::FieldDecl& fieldDecl)
+        {
+            std::vector<const clang::Expr*> inits;
 
-            // replace header
-            const clang::SourceRange fileStartToFirstDeclBegin(fileStart, sourceRange->getBegin().getLocWithOffset(-1));
-            if (fileStartToFirstDeclBegin.isValid())
-            { 
-                rewriter.replace(fileStartToFirstDeclBegin, header);
+            if (fieldDecl.hasInClassInitializer())
+            {
+                inits.push_back(fieldDecl.getInClassInitializer());
             }
 
-            // remove everything that is not relevant for the proxy generation
-            for (std::uint32_t i = 0; i < (numRelevantSourceRanges - 1); ++i)
+            const clang::CXXRecordDecl* const recordDecl = llvm::dyn_cast<clang::CXXRecordDecl>(fieldDecl.getParent());
+            if (!recordDecl) return inits;
+
+            for (const auto constructor : recordDecl->ctors())
             {
+                const clang::FunctionDecl* definition = nullptr;
+                if (!constructor->hasBody(definition)) continue;
 
-                const clang::SourceLocation start = sourceRange->getEnd().getLocWithOffset(1);
-                const clang::SourceLocation end = (++sourceRange)->getBegin().getLocWithOffset(-1);
-                const clang::SourceRange toBeRemoved(start, end);
-                if (toBeRemoved.isValid() && toBeRemoved.getBegin() != toBeRemoved.getEnd())
+                const clang::CXXConstructorDecl* const constructorDefinition = llvm::dyn_cast<clang::CXXConstructorDecl>(definition);
+                if (!constructorDefinition || constructorDefinition->isImplicit()) continue;
+
+                bool isInitialized = false;
+                for (const auto initializer : constructorDefinition->inits())
                 {
-                    rewriter.remove(toBeRemoved);
+                    if (initializer->isWritten() && initializer->getMember() == &fieldDecl)
+                    {
+                        inits.push_back(initializer->getInit());
+                        isInitialized = true;
+                    }
                 }
-            }
 
-            const clang::SourceRange toBeRemoved(sourceRange->getEnd().getLocWithOffset(1), fileEnd);
-            if (toBeRemoved.isValid() && toBeRemoved.getBegin() != toBeRemoved.getEnd())
-            {
-                rewriter.replace(toBeRemoved, std::string("\n"));
+                // delegating constructors initialize the data member through their target
+                if (!isInitialized && !fieldDecl.hasInClassInitializer() && !constructorDefinition->isDelegatingConstructor())
+                {
+                    inits.push_back(nullptr);
+                }
             }
 
-            // declaration: replace class name by proxy class name
-            const std::string proxyNamespace = std::string("proxy_internal");
-
-            const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
-            if (!declaration.isDefinition)
-            {
-                // insert proxy namespace
-                const Indentation Indent = declaration.indent;
-                const std::string indent(Indent.value, ' ');
+            return inits;
+        }
 
-                rewriter.insert(declaration.extendedSourceRange.getBegin(), indent + std::string("namespace ") + proxyNamespace + std::string("\n") + indent + std::string("{\n"));
-                rewriter.insert(declaration.extendedSourceRange.getEnd(), indent + std::string("\n") + indent + std::string("}\n"));
+        // 'v[i]', 'v.at(i)' or 'row' with 'row' being a reference to a row of 'v': returns 'v'
+        static const clang::ValueDecl* getRowOwner(const clang::Expr& expr, const std::map<const clang::ValueDecl*, const clang::ValueDecl*>& rowVariables)
+        {
+            const clang::Expr* const rowExpr = expr.IgnoreParenImpCasts();
+            const clang::Expr* object = nullptr;
 
-                rewriter.replace(declaration.nameSourceRange, declaration.name + std::string("_proxy"));
+            if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(rowExpr))
+            {
+                if (operatorCallExpr->getOperator() == clang::OO_Subscript) object = operatorCallExpr->getArg(0);
             }
-
-            // target class namespace prefix
-            std::string targetClassNamespace;
-            for (const auto& thisNamespace : candidate->getDeclaration().namespaces)
+            else if (const clang::CXXMemberCallExpr* const memberCallExpr = llvm::dyn_cast<clang::CXXMemberCallExpr>(rowExpr))
             {
-                targetClassNamespace += (thisNamespace.name + std::string("::"));
+                const clang::CXXMethodDecl* const method = memberCallExpr->getMethodDecl();
+                if (method && method->getNameAsString() == std::string("at")) object = memberCallExpr->getImplicitObjectArgument();
             }
-
-            // definitions
-            const std::vector<ClassMetaData::Definition>& definitions = candidate->getDefinitions();
-            for (const auto& definition : definitions)
+            else if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(rowExpr))
             {
-                // insert proxy namespace
-                const Indentation Indent = definition.declaration.indent;
-                const std::string indent(Indent.value, ' ');
+                const auto rowVariable = rowVariables.find(declRefExpr->getDecl());
 
-                rewriter.insert(definition.extendedSourceRange.getBegin(), indent + std::string("namespace ") + proxyNamespace + std::string("\n") + indent + std::string("{\n"));
-                rewriter.insert(definition.extendedSourceRange.getEnd(), indent + std::string("\n") + indent + std::string("}\n"));
+                return (rowVariable != rowVariables.end() ? rowVariable->second : nullptr);
+            }
 
-                // replace class name by proxy class name
-                rewriter.replace(definition.nameSourceRange, definition.name + std::string("_proxy"));
+            return (object ? getReferencedDeclaration(*(object->IgnoreParenImpCasts())) : nullptr);
+        }
 
-                // indentation
-                const Indentation ExtIndent = Indent + 1;
-                const std::string extIndent(ExtIndent.value, ' ');
-                const Indentation ExtExtIndent = ExtIndent + 1;
-                const std::string extExtIndent(ExtExtIndent.value, ' ');
+        // vectors of vectors are jagged unless all their initializers give all row lengths, e.g. 'v(n, std::vector<T>(m))', and no row changes its length:
+        // rows change their length through member calls ('v[i].push_back(x)', 'row.resize(m)', 'v[i].swap(w)', ...), assignments ('v[i] = std::vector<T>(m)')
+        // and 'swap(v[i], w)', where rows are 'v[i]', 'v.at(i)' and references to them ('auto& row = v[i]', 'for (auto& row : v)')
+        void findJaggedDeclarations(clang::ASTContext& context)
+        {
+            using namespace clang::ast_matchers;
 
-                // open private region
-                rewriter.insert(definition.innerLocBegin, std::string("\n") + indent + std::string("private:\n"));
+            std::set<const clang::ValueDecl*> vectorsOfVectors;
+            for (const auto& declaration : declarations)
+            {
+                if (!isVectorOfVectors(*declaration)) continue;
 
-                // friend declarations
-                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("template <typename _X, std::size_t _N, std::size_t _D, XXX_NAMESPACE::data_layout _L>\n") + extIndent + std::string("friend class XXX_NAMESPACE::internal::accessor;\n"));
-                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("template <typename _P, std::size_t _R>\n") + extIndent + std::string("friend class XXX_NAMESPACE::internal::iterator;\n"));
+                vectorsOfVectors.insert(&declaration->decl);
 
-                // insert meta data: unqualified type
-                for (const auto& templateParamter : definition.declaration.templateParameters)
+                // data members are initialized in their declaration or in the constructors: all of these initializations must be rectangular
+                std::vector<const clang::Expr*> inits;
+                if (const clang::VarDecl* const varDecl = llvm::dyn_cast<clang::VarDecl>(&declaration->decl))
                 {
-                    if (!templateParamter.isTypeParameter) continue;
+                    inits.push_back(varDecl->getInit());
+                }
+                else if (const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(&declaration->decl))
+                {
+                    inits = getMemberInitializers(*fieldDecl);
+                }
 
-                    const std::string parameterName = templateParamter.name;
+                const bool isRectangular = (inits.size() > 0 && std::all_of(inits.begin(), inits.end(),
+                    [&declaration, &context, this] (const clang::Expr* init) { return (init && getExtentStringFromInitializer(*declaration, init, context).size() > 0); }));
 
-                    rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("using ") + parameterName + std::string("_unqualified = typename std::remove_cv<") + parameterName + std::string(">::type;\n"));
+                if (!isRectangular)
+                {
+                    jaggedDeclarations.insert(&declaration->decl);
                 }
+            }
 
-                // insert meta data: is const type?
-                if (definition.declaration.templateParameters.size() > 0)
+            if (vectorsOfVectors.empty()) return;
+
+            std::vector<const clang::VarDecl*> references;
+            std::vector<const clang::CXXForRangeStmt*> loops;
+            std::vector<const clang::CallExpr*> calls;
+
+            Matcher matcher;
+            matcher.addMatcher(varDecl(hasType(lValueReferenceType())).bind("reference"),
+                [&references] (const MatchFinder::MatchResult& result) mutable
                 {
-                    std::stringstream isConstTypeStream;
-                    isConstTypeStream << "\n" << extIndent << "static constexpr bool is_const_type = (";
-                    std::uint32_t templateParameterId = 0;
-                    for (const auto& templateParamter : definition.declaration.templateParameters)
-                    {
-                        if (!templateParamter.isTypeParameter) continue;
+                    if (const clang::VarDecl* const decl = result.Nodes.getNodeAs<clang::VarDecl>("reference")) references.push_back(decl);
+                });
+            matcher.addMatcher(cxxForRangeStmt().bind("loop"),
+                [&loops] (const MatchFinder::MatchResult& result) mutable
+                {
+                    if (const clang::CXXForRangeStmt* const loop = result.Nodes.getNodeAs<clang::CXXForRangeStmt>("loop")) loops.push_back(loop);
+                });
+            matcher.addMatcher(callExpr().bind("call"),
+                [&calls] (const MatchFinder::MatchResult& result) mutable
+                {
+                    if (const clang::CallExpr* const callExpr = result.Nodes.getNodeAs<clang::CallExpr>("call")) calls.push_back(callExpr);
+                });
+            matcher.run(context);
 
-                        const std::string parameterName = templateParamter.name;
+            // rows of parameters the declarations are passed to are rows of these declarations
+            const auto getOwner = [this] (const clang::ValueDecl* const decl) -> const clang::ValueDecl*
+                {
+                    const Declaration* const declaration = findDeclaration(decl);
 
-                        isConstTypeStream << (templateParameterId == 0 ? "" : " || " ) << "std::is_const<" << parameterName << ">::value";
-                        ++templateParameterId;
-                    }
-                    isConstTypeStream << ");\n";
-                    rewriter.insert(definition.innerLocBegin, isConstTypeStream.str());
-                }
+                    return (declaration ? &declaration->decl : nullptr);
+                };
 
-                // open public region
-                rewriter.insert(definition.innerLocBegin, std::string("\n") + indent + std::string("public:\n"));
+            // non-const references to rows
+            std::map<const clang::ValueDecl*, const clang::ValueDecl*> rowVariables;
+            for (const auto decl : references)
+            {
+                if (decl->getType().getNonReferenceType().isConstQualified() || !decl->getInit()) continue;
 
-                const clang::SourceLocation publicAccess = definition.accessSpecifiers[definition.indexPublicAccessSpecifiers[0]].scopeBegin;
+                const clang::ValueDecl* const owner = getOwner(getRowOwner(*(decl->getInit()), rowVariables));
+                if (vectorsOfVectors.find(owner) != vectorsOfVectors.end()) rowVariables[decl] = owner;
+            }
 
-                // insert meta data: type and const_type
-                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("using type = ") + definition.name + std::string("_proxy") + definition.templateParameterString + std::string(";\n"));
-                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("using const_type = ") + definition.name + std::string("_proxy") + definition.templateConstParameterString + std::string(";\n"));
+            for (const auto loop : loops)
+            {
+                const clang::VarDecl* const loopVariable = loop->getLoopVariable();
+                const clang::Expr* const rangeInit = loop->getRangeInit();
+                if (!loopVariable || !rangeInit || !loopVariable->getType()->isLValueReferenceType() || loopVariable->getType().getNonReferenceType().isConstQualified()) continue;
 
-                // insert meta data: base pointer type?
-                std::stringstream basePointerStream;
-                basePointerStream << "\n" << extIndent << "using base_pointer = XXX_NAMESPACE::multi_pointer_";
-                if (definition.isHomogeneous)
+                const clang::ValueDecl* const owner = getOwner(getReferencedDeclaration(*(rangeInit->IgnoreParenImpCasts())));
+                if (vectorsOfVectors.find(owner) != vectorsOfVectors.end()) rowVariables[loopVariable] = owner;
+            }
+
+            const std::set<std::string> rowGrowthMethods = {"push_back", "emplace_back", "pop_back", "resize", "reserve", "clear", "insert", "emplace", "erase", "assign", "swap", "operator="};
+
+            for (const auto callExpr : calls)
+            {
+                const clang::ValueDecl* owner = nullptr;
+                std::string methodName("");
+
+                if (const clang::CXXMemberCallExpr* const memberCallExpr = llvm::dyn_cast<clang::CXXMemberCallExpr>(callExpr))
                 {
-                    basePointerStream << "n<" << definition.fields[0].elementTypeName << ", " << std::to_string(definition.fields.size());
+                    // v[i].push_back(...), row.assign(...)
+                    const clang::CXXMethodDecl* const method = memberCallExpr->getMethodDecl();
+                    methodName = (method ? method->getNameAsString() : std::string(""));
+                    if (memberCallExpr->getImplicitObjectArgument() && rowGrowthMethods.find(methodName) != rowGrowthMethods.end())
+                    {
+                        owner = getRowOwner(*(memberCallExpr->getImplicitObjectArgument()), rowVariables);
+                    }
                 }
-                else
+                else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(callExpr))
                 {
-                    basePointerStream << "inhomogeneous<";
-
-                    std::uint32_t fieldId = 0;
-                    for (const auto& field : definition.fields)
+                    // v[i] = std::vector<T>(m)
+                    if (operatorCallExpr->getOperator() == clang::OO_Equal && operatorCallExpr->getNumArgs() == 2)
                     {
-                        basePointerStream << (fieldId == 0 ? "" : ", ") << field.elementTypeName;
-                        ++fieldId;
+                        owner = getRowOwner(*(operatorCallExpr->getArg(0)), rowVariables);
                     }
                 }
-                basePointerStream << ">;\n";
-                rewriter.insert(definition.innerLocBegin, basePointerStream.str());
-
-                // insert meta data: original type
-                std::stringstream originalType;
+                else
                 {
-                    originalType << targetClassNamespace << definition.name;
-                    std::uint32_t templateParameterId = 0;
-                    for (const auto& templateParamter : definition.declaration.templateParameters)
+                    // swap(v[i], w), std::swap(row, w)
+                    const clang::FunctionDecl* const callee = callExpr->getDirectCallee();
+                    if (callee && callee->getNameAsString() == std::string("swap"))
                     {
-                        const std::string parameterName = (definition.isTemplatePartialSpecialization ? definition.templatePartialSpecializationArguments[templateParameterId].first : templateParamter.name) +
-                            std::string(templateParamter.isTypeParameter ? "_unqualified" : "");
-
-                        originalType << (templateParameterId == 0 ? "<" : ", ") << parameterName;
-                        ++templateParameterId;
-                        if (templateParameterId == definition.declaration.templateParameters.size())
+                        for (std::uint32_t i = 0; i < callExpr->getNumArgs() && !owner; ++i)
                         {
-                            originalType << ">";        
+                            owner = getRowOwner(*(callExpr->getArg(i)), rowVariables);
                         }
                     }
                 }
 
-                std::stringstream originalTypeStream;
-                if (definition.declaration.templateParameters.size() > 0)
-                {
-                    originalTypeStream << "\n" << extIndent << "using original_type = typename std::conditional<is_const_type,\n";
-                    originalTypeStream << extExtIndent << "const " << originalType.str() << ",\n";
-                    originalTypeStream << extExtIndent << originalType.str();
-                    originalTypeStream << ">::type;\n";
+                owner = getOwner(owner);
+                if (vectorsOfVectors.find(owner) == vectorsOfVectors.end()) continue;
 
-                }
-                else
-                {
-                    originalTypeStream << "\n" << extIndent << "using original_type = " << definition.name << ";\n";
-                }
-                
-                rewriter.insert(definition.innerLocBegin, originalTypeStream.str());
+                jaggedDeclarations.insert(owner);
 
-                // open private region for classes
-                if (definition.declaration.isClass)
+                if (methodName == std::string("emplace_back"))
                 {
-                    rewriter.insert(definition.innerLocBegin, std::string("\n") + indent + std::string("private:\n"));
+                    for (const auto& declaration : declarations)
+                    {
+                        if (&declaration->decl == owner) appendCalls.push_back(std::make_pair(llvm::cast<clang::CXXMemberCallExpr>(callExpr), declaration));
+                    }
                 }
+            }
+        }
 
-                // constructors
-                std::vector<std::string> proxyClassConstructors;
-                proxyClassConstructors.emplace_back(generateProxyClassConstructor(definition));
-                proxyClassConstructors.emplace_back(generateProxyClassTupleConstructor(definition));
-
-                const std::uint32_t numConstructorsToBeInserted = proxyClassConstructors.size();
-                const std::uint32_t numConstructorLocationsAvailable = definition.indexPublicConstructors.size();
-                const std::uint32_t numConstructorsInserted = std::min(numConstructorLocationsAvailable, numConstructorsToBeInserted);
-                for (std::uint32_t i = 0; i < numConstructorsInserted; ++i)
-                {
-                    rewriter.replace(definition.constructors[definition.indexPublicConstructors[i]].sourceRange, proxyClassConstructors[i]);
-                }
-                const clang::SourceLocation fallbackSourceLocation = (definition.indexPublicAccessSpecifiers.size() > 0 ? definition.accessSpecifiers[definition.indexPublicAccessSpecifiers[0]].scopeBegin : definition.innerLocBegin);
-                for (std::uint32_t i = numConstructorsInserted; i < proxyClassConstructors.size(); ++i)
-                {
-                    rewriter.insert(fallbackSourceLocation, std::string("\n") + proxyClassConstructors[i]);
-                }
+        // the declaration itself, its template pattern or a parameter it is passed to
+        const Declaration* findDeclaration(const clang::ValueDecl* const decl) const
+        {
+            for (const auto& declaration : declarations)
+            {
+                if (&declaration->decl == decl) return declaration;
+            }
 
-                for (std::uint32_t i = numConstructorsInserted; i < definition.constructors.size(); ++i)
-                {
-                    rewriter.remove(definition.constructors[i].sourceRange);
-                }
+            const auto pattern = templatePatterns.find(decl);
+            if (pattern != templatePatterns.end()) return findDeclaration(pattern->second);
 
-                // adapt functions
-                for (const auto& method : definition.cxxMethods)
+            const auto parameter = propagatedParameters.find(decl);
+
+            return (parameter != propagatedParameters.end() ? parameter->second : nullptr);
+        }
+
+        // declarations passed to functions whose parameters cannot be adapted are not transformed (this may affect other calls)
+        void propagateParameters(clang::ASTContext& context)
+        {
+            while (true)
+            {
+                std::map<const Declaration*, std::string> bufferTypeNames;
+                std::set<const Declaration*> stridedDeclarations;
+                for (const auto& declaration : declarations)
                 {
-                    if (!method.hasClassTypeArguments && !method.returnsClassType) continue;
+                    bufferTypeNames[declaration] = generateBufferTypeName(*declaration);
 
-                    // only return value is of class type
-                    if (method.returnsClassType && !method.hasClassTypeArguments)
+                    if (isStridedDeclaration(*declaration))
                     {
-                        if (method.returnsClassTypeReference)
-                        {
-                            rewriter.replace(getSpellingSourceRange(method.returnTypeSourceRange, context), definition.name + std::string("_proxy"));
-                        }
-                        else
-                        {
-                            // TODO: fix that -> for some reason the closing bracket of the body is not included -> add "1"
-                            const clang::SourceRange selectionSourceRange(method.macroDefinitionSourceRange.getBegin(), method.macroDefinitionSourceRange.getEnd().getLocWithOffset(1));
-                            std::string selection = dumpSourceRangeToString(selectionSourceRange, sourceManager);
-                            findAndReplace(selection, definition.name, originalType.str(), true, true);
-                            rewriter.replace(selectionSourceRange, selection);
-                        }
+                        stridedDeclarations.insert(declaration);
                     }
+                }
 
-                    // return value and arguments can be of class type
-                    if (method.hasClassTypeArguments)
+                parameterPropagation.reset(new ParameterPropagation(declarations, bufferTypeNames, stridedDeclarations, context));
+
+                const auto& nonAdaptableDeclarations = parameterPropagation->getNonAdaptableDeclarations();
+                if (nonAdaptableDeclarations.empty()) break;
+
+                for (auto it = declarations.begin(); it != declarations.end(); )
+                {
+                    const auto nonAdaptableDeclaration = nonAdaptableDeclarations.find(*it);
+                    if (nonAdaptableDeclaration == nonAdaptableDeclarations.end())
                     {
-                        modifyMethodSignature(definition, method, rewriter, std::string(""), targetClassNamespace, true);
+                        ++it;
+                        continue;
                     }
-                }
 
-                // change field types -> reference values
-                for (const auto& field : definition.fields)
-                {
-                    rewriter.replace(field.sourceRange, field.typeName + std::string("& ") + field.name);
+                    const clang::ValueDecl* const decl = &((*it)->decl);
+                    std::cerr << "warning: " << nonAdaptableDeclaration->second << " -> " << decl->getNameAsString() << " not transformed" << std::endl;
+
+                    appendCalls.erase(std::remove_if(appendCalls.begin(), appendCalls.end(),
+                        [&it] (const std::pair<const clang::CXXMemberCallExpr*, const Declaration*>& call) { return (call.second == *it); }), appendCalls.end());
+                    growableDeclarations.erase(decl);
+                    concurrentAppendDeclarations.erase(decl);
+                    jaggedDeclarations.erase(decl);
+                    indexSpaces.erase(*it);
+
+                    delete *it;
+                    it = declarations.erase(it);
                 }
             }
+
+            propagatedParameters = parameterPropagation->getPropagatedParameters();
         }
 
-        std::vector<const clang::FunctionDecl*> findFunctionsWithTargetParameters(const ClassMetaData& target)
+        // vectors that grow need growable buffers: all streams are reallocated together with amortized geometric growth
+        void findGrowableDeclarations(clang::ASTContext& context)
         {
             using namespace clang::ast_matchers;
 
+            std::set<const clang::ValueDecl*> rejectedDeclarations;
+
             Matcher matcher;
-            clang::ASTContext& context = target.context;
-            std::vector<const clang::FunctionDecl*> functions;
-            
-            matcher.addMatcher(functionDecl().bind("functionDeclaration"),
-                    [this, &target, &context, &functions] (const MatchFinder::MatchResult& result) mutable
+            // deques also grow and shrink at the front: none of these is possible with a fixed-size (chunked) buffer
+            matcher.addMatcher(cxxMemberCallExpr(callee(cxxMethodDecl(anyOf(hasName("push_back"), hasName("emplace_back"), hasName("resize"), hasName("reserve"), hasName("pop_back"),
+                hasName("push_front"), hasName("emplace_front"), hasName("pop_front"))))).bind("growth"),
+                [&rejectedDeclarations, &context, this] (const MatchFinder::MatchResult& result) mutable
+                {
+                    const clang::CXXMemberCallExpr* const callExpr = result.Nodes.getNodeAs<clang::CXXMemberCallExpr>("growth");
+                    if (!callExpr || !callExpr->getImplicitObjectArgument()) return;
+
+                    const clang::Expr* const object = callExpr->getImplicitObjectArgument()->IgnoreParenImpCasts();
+                    const clang::ValueDecl* objectDecl = nullptr;
+                    if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(object))
                     {
-                        if (const clang::FunctionDecl* const decl = result.Nodes.getNodeAs<clang::FunctionDecl>("functionDeclaration"))
-                        {
-                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
-                            
-                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
-                                sourceLocationString.find("usr/include") != std::string::npos) return;
+                        objectDecl = declRefExpr->getDecl();
+                    }
+                    else if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(object))
+                    {
+                        objectDecl = memberExpr->getMemberDecl();
+                    }
 
-                            if (decl->getNumParams() == 0) return;
+                    // growth through a parameter the declaration is passed to counts for the declaration
+                    const Declaration* const declaration = findDeclaration(objectDecl);
+                    if (!declaration || !declaration->isContainerDeclaration()) return;
 
-                            bool hasTargetArgument = false;
-                            for (const auto& parameter : decl->parameters())
-                            {
-                                if (parameter->getType().getAsString().find(target.getDeclaration().name) != std::string::npos)
-                                {
-                                    hasTargetArgument = true;
-                                    break;
-                                }
-                            }
+                    // jagged buffers append rows themselves
+                    if (isJaggedDeclaration(*declaration)) return;
 
-                            if (!hasTargetArgument) return;
+                    // e.g. 'std::vector<std::array<T, 3>> v' with 'v.push_back(...)'
+                    if (declaration->getNestingLevel() > 0)
+                    {
+                        rejectedDeclarations.insert(&declaration->decl);
+                        return;
+                    }
 
-                            // skip all functions that are within the definition of any of the classes considered
-                            for (const auto& definition : target.getDefinitions())
-                            {
-                                const std::size_t defBeginLine = getSpellingLineNumber(definition.sourceRange.getBegin(), context);
-                                const std::size_t defEndLine = getSpellingLineNumber(definition.sourceRange.getEnd(), context);
-                                const std::size_t declBeginLine = getSpellingLineNumber(decl->getSourceRange().getBegin(), context);
+                    growableDeclarations.insert(&declaration->decl);
 
-                                if (defBeginLine < declBeginLine && declBeginLine < defEndLine) return;
-                            }
+                    const std::string methodName = callExpr->getMethodDecl()->getNameAsString();
+                    const bool isAppend = (methodName == std::string("push_back") || methodName == std::string("emplace_back"));
+                    const bool isConcurrentAppend = (isAppend && isInsideParallelRegion(*callExpr, context));
 
-                            for (const auto& definitionSourceRange : target.getDefinitionsSortedOut())
-                            {
-                                const std::size_t defBeginLine = getSpellingLineNumber(definitionSourceRange.getBegin(), context);
-                                const std::size_t defEndLine = getSpellingLineNumber(definitionSourceRange.getEnd(), context);
-                                const std::size_t declBeginLine = getSpellingLineNumber(decl->getSourceRange().getBegin(), context);
+                    if (isConcurrentAppend)
+                    {
+                        concurrentAppendDeclarations.insert(&declaration->decl);
+                    }
 
-                                if (defBeginLine < declBeginLine && declBeginLine < defEndLine) return;
-                            }
+                    if (isConcurrentAppend || methodName == std::string("emplace_back") || methodName == std::string("emplace_front"))
+                    {
+                        appendCalls.push_back(std::make_pair(callExpr, declaration));
+                    }
+                });
+            matcher.run(context);
 
-                            const auto& it = std::lower_bound(functions.begin(), functions.end(), decl, [&context] (const clang::FunctionDecl* d_1, const clang::FunctionDecl* d_2)
-                                {
-                                    const std::size_t beginLoc_d_1 = getSpellingLineNumber(d_1->getSourceRange().getBegin(), context);
-                                    const std::size_t beginLoc_d_2 = getSpellingLineNumber(d_2->getSourceRange().getBegin(), context);
-                                    return (beginLoc_d_1 < beginLoc_d_2);
-                                });
+            if (rejectedDeclarations.empty()) return;
 
+            for (auto it = declarations.begin(); it != declarations.end(); )
+            {
+                const clang::ValueDecl* const decl = &((*it)->decl);
+                if (rejectedDeclarations.find(decl) == rejectedDeclarations.end())
+                {
+                    ++it;
+                    continue;
+                }
 
-                            if (it == functions.end() || (*it)->getSourceRange() != decl->getSourceRange())
-                            {
-                                functions.insert(it, decl);
-                            }
-                        }
-                    });
+                std::cerr << "warning: growth of nested containers is not supported: " << decl->getNameAsString() << " -> not transformed" << std::endl;
 
-            matcher.run(target.context);
+                appendCalls.erase(std::remove_if(appendCalls.begin(), appendCalls.end(),
+                    [&it] (const std::pair<const clang::CXXMemberCallExpr*, const Declaration*>& call) { return (call.second == *it); }), appendCalls.end());
+                growableDeclarations.erase(decl);
+                concurrentAppendDeclarations.erase(decl);
 
-            return functions;
+                delete *it;
+                it = declarations.erase(it);
+            }
         }
-        
-        void addProxyClassToSource(const std::vector<std::unique_ptr<ClassMetaData>>& proxyClassTargets, clang::ASTContext& context)
+
+        // proxies cannot construct elements in place: 'v.emplace_back(a, b)' -> 'v.push_back(T(a, b))' ('emplace_front' -> 'push_front' for deques)
+        // inside OpenMP parallel regions: 'v.push_back(x)' -> 'v.concurrent_push_back(x)'
+        void modifyAppendCalls(std::set<clang::FileID>& outputFiles, clang::ASTContext& context)
         {
-            // make a hard copy before applying any changes to the source code
-            Rewriter proxyClassCreator(rewriter);
-        
-            for (const auto& target : proxyClassTargets)
+            const clang::SourceManager& sourceManager = context.getSourceManager();
+
+            for (const auto& call : appendCalls)
             {
-                if (!target->containsProxyClassCandidates) continue;
+                const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(call.first->getCallee()->IgnoreParenImpCasts());
+                if (!memberExpr) continue;
 
-                // check if the source file containing the original code, also contains function definitions with class type paramters: add them if needed
-                std::vector<const clang::FunctionDecl*> functionsWithTargetParameters = findFunctionsWithTargetParameters(*target);
+                const bool isConcurrentAppend = (concurrentAppendDeclarations.find(&call.second->decl) != concurrentAppendDeclarations.end() && isInsideParallelRegion(*call.first, context));
+                const bool isFrontAppend = (call.first->getMethodDecl()->getNameAsString() == std::string("emplace_front"));
+                const std::string methodName = (isConcurrentAppend ? std::string("concurrent_push_back") : (isFrontAppend ? std::string("push_front") : std::string("push_back")));
 
-                for (const auto& function : functionsWithTargetParameters)
+                if (call.first->getMethodDecl()->getNameAsString() == std::string("push_back"))
                 {
-                    const clang::FileID fileId = context.getSourceManager().getFileID(function->getLocation());
-                    if (fileId == target->fileId)
-                    {
-                        const clang::FunctionTemplateDecl* templateFunctionDecl = function->getDescribedFunctionTemplate();
-                        const clang::SourceRange functionSourceRange = (templateFunctionDecl == nullptr ? function->getSourceRange() : templateFunctionDecl->getSourceRange());
-                        target->getRelevantSourceRanges().insert(clang::SourceRange(getBeginOfLine(functionSourceRange.getBegin(), context), functionSourceRange.getEnd()));
-                    }
+                    const clang::SourceLocation beginLoc = memberExpr->getMemberLoc();
+                    const clang::FileID fileId = sourceManager.getFileID(beginLoc);
+
+                    rewriter.getEditBuffer(fileId).ReplaceText(sourceManager.getFileOffset(beginLoc), std::string("push_back").length(), methodName);
+                    outputFiles.insert(fileId);
+                    continue;
                 }
-                target->updateRelevantSourceRangeInfo();
 
-                //////////////////////////////////////////////////////////////////////////////////////////////////////////
-                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+                std::string arguments("");
+                const std::size_t numArgs = call.first->getNumArgs();
+                if (numArgs > 0)
+                {
+                    arguments = dumpTokenRangeToString(clang::SourceRange(call.first->getArg(0)->getBeginLoc(), call.first->getArg(numArgs - 1)->getEndLoc()), sourceManager);
+                }
 
-                // modify original source code
-                modifyOriginalSourceCode(target, rewriter);
+                const clang::SourceLocation beginLoc = memberExpr->getMemberLoc();
+                const clang::SourceLocation endLoc = call.first->getRParenLoc();
+                const clang::FileID fileId = sourceManager.getFileID(beginLoc);
+                const std::size_t offset = sourceManager.getFileOffset(beginLoc);
+
+                rewriter.getEditBuffer(fileId).ReplaceText(offset, sourceManager.getFileOffset(endLoc) + 1 - offset,
+                    methodName + std::string("(") + call.second->elementDataTypeSpelling + std::string("(") + arguments + std::string("))"));
+                outputFiles.insert(fileId);
+            }
+        }
+
+        static const clang::ValueDecl* getReferencedDeclaration(const clang::Expr& expr)
+        {
+            if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(&expr))
+            {
+                return declRefExpr->getDecl();
+            }
+            else if (const clang::MemberExpr* const memberExpr = llvm::dyn_cast<clang::MemberExpr>(&expr))
+            {
+                return memberExpr->getMemberDecl();
+            }
+
+            return nullptr;
+        }
+
+        // 'v.begin()', 'v.cend()', 'std::begin(v)', ... -> 'v'
+        static const clang::ValueDecl* getIteratorDeclaration(const clang::Expr& iterator)
+        {
+            const clang::Expr* expr = iterator.IgnoreImplicit();
+            while (const clang::CXXConstructExpr* const constructExpr = llvm::dyn_cast<clang::CXXConstructExpr>(expr))
+            {
+                if (constructExpr->getNumArgs() != 1) return nullptr;
+
+                expr = constructExpr->getArg(0)->IgnoreImplicit();
+            }
+
+            const std::set<std::string> iteratorFunctions = {"begin", "end", "cbegin", "cend", "rbegin", "rend", "crbegin", "crend"};
+            const clang::Expr* container = nullptr;
+            if (const clang::CXXMemberCallExpr* const memberCallExpr = llvm::dyn_cast<clang::CXXMemberCallExpr>(expr))
+            {
+                const clang::CXXMethodDecl* const method = memberCallExpr->getMethodDecl();
+                if (method && iteratorFunctions.find(method->getNameAsString()) != iteratorFunctions.end()) container = memberCallExpr->getImplicitObjectArgument();
+            }
+            else if (const clang::CallExpr* const callExpr = llvm::dyn_cast<clang::CallExpr>(expr))
+            {
+                const clang::FunctionDecl* const callee = callExpr->getDirectCallee();
+                if (callee && callExpr->getNumArgs() == 1 && iteratorFunctions.find(callee->getNameAsString()) != iteratorFunctions.end()) container = callExpr->getArg(0);
+            }
+
+            return (container ? getReferencedDeclaration(*(container->IgnoreParenImpCasts())) : nullptr);
+        }
+
+        // proxies are returned by value: 'T& x' -> 'auto&& x', 'const T& x' -> 'const auto& x', and copies of elements 'auto x' -> 'T x'
+        void modifyElementReference(const clang::VarDecl& variable, const Declaration* const elementDeclaration, std::set<const clang::VarDecl*>& modifiedVariables, std::set<clang::FileID>& outputFiles, clang::ASTContext& context)
+        {
+            const clang::QualType type = variable.getType();
+            std::string typeName("");
+
+            if (type->isLValueReferenceType())
+            {
+                typeName = (type.getNonReferenceType().isConstQualified() ? std::string("const auto&") : std::string("auto&&"));
+            }
+            else if (elementDeclaration && !type->isReferenceType() && llvm::isa<clang::AutoType>(type.getTypePtr()))
+            {
+                typeName = (type.isConstQualified() ? std::string("const ") : std::string("")) + elementDeclaration->elementDataTypeSpelling;
+            }
+
+            if (typeName == std::string("") || llvm::isa<clang::DecompositionDecl>(&variable) || variable.getName().empty() || variable.getBeginLoc().isMacroID()) return;
+            if (!modifiedVariables.insert(&variable).second) return;
+
+            const clang::SourceManager& sourceManager = context.getSourceManager();
+            const clang::FileID fileId = sourceManager.getFileID(variable.getBeginLoc());
+            const std::size_t offset = sourceManager.getFileOffset(variable.getBeginLoc());
+
+            rewriter.getEditBuffer(fileId).ReplaceText(offset, sourceManager.getFileOffset(variable.getLocation()) - offset, typeName + std::string(" "));
+            outputFiles.insert(fileId);
+        }
+
+        // range-based for loops over buffers and their rows, and lambdas passed to standard algorithms together with buffer iterators
+        // (including the parallel overloads taking an execution policy): the buffer iterators are random access iterators
+        // that return proxies by value
+        void modifyElementReferences(std::set<clang::FileID>& outputFiles, clang::ASTContext& context)
+        {
+            using namespace clang::ast_matchers;
+
+            std::vector<const clang::CXXForRangeStmt*> loops;
+            std::vector<const clang::CallExpr*> algorithmCalls;
 
+            Matcher matcher;
+            matcher.addMatcher(cxxForRangeStmt(unless(isExpansionInSystemHeader()), unless(isInTemplateInstantiation())).bind("loop"),
+                [&loops] (const MatchFinder::MatchResult& result) mutable
                 {
-                    std::string outputString;
-                    llvm::raw_string_ostream outputStream(outputString);
-                    rewriter.getEditBuffer(target->fileId).write(outputStream);
-            
-                    std::string outputFilename(target->filename);
-                    const std::size_t pos = outputFilename.rfind('/');
+                    if (const clang::CXXForRangeStmt* const loop = result.Nodes.getNodeAs<clang::CXXForRangeStmt>("loop")) loops.push_back(loop);
+                });
+            matcher.addMatcher(callExpr(unless(isExpansionInSystemHeader()), unless(isInTemplateInstantiation())).bind("algorithm"),
+                [&algorithmCalls] (const MatchFinder::MatchResult& result) mutable
+                {
+                    const clang::CallExpr* const callExpr = result.Nodes.getNodeAs<clang::CallExpr>("algorithm");
+                    const clang::FunctionDecl* const callee = (callExpr ? callExpr->getDirectCallee() : nullptr);
+                    if (callee && callee->isInStdNamespace()) algorithmCalls.push_back(callExpr);
+                });
+            matcher.run(context);
 
-                    if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
+            std::map<const clang::ValueDecl*, std::pair<const Declaration*, std::uint32_t>>& ranges = elementRanges;
+            for (const auto& declaration : declarations)
+            {
+                ranges[&declaration->decl] = std::make_pair(declaration, 0);
+            }
+
+            // parameters that become buffers
+            for (const auto& parameter : propagatedParameters)
+            {
+                ranges[parameter.first] = std::make_pair(parameter.second, 0);
+            }
+
+            // template code refers to the pattern declarations
+            for (const auto& pattern : templatePatterns)
+            {
+                const auto range = ranges.find(pattern.second);
+                if (range != ranges.end()) ranges[pattern.first] = range->second;
+            }
+
+            std::set<const clang::VarDecl*> modifiedVariables;
+
+            // note: outer loops are matched before the loops nested in them
+            for (const auto loop : loops)
+            {
+                const clang::Expr* const rangeInit = loop->getRangeInit();
+                const clang::ValueDecl* const rangeDecl = (rangeInit ? getReferencedDeclaration(*(rangeInit->IgnoreParenImpCasts())) : nullptr);
+                const auto range = ranges.find(rangeDecl);
+                if (range == ranges.end() || range->second.second > range->second.first->getNestingLevel()) continue;
+
+                const Declaration* const declaration = range->second.first;
+                const std::uint32_t level = range->second.second;
+                const bool isElement = (level == declaration->getNestingLevel());
+
+                ranges[loop->getLoopVariable()] = std::make_pair(declaration, level + 1);
+
+                modifyElementReference(*(loop->getLoopVariable()), (isElement ? declaration : nullptr), modifiedVariables, outputFiles, context);
+            }
+
+            for (const auto callExpr : algorithmCalls)
+            {
+                const Declaration* declaration = nullptr;
+                for (const auto argument : callExpr->arguments())
+                {
+                    const auto range = ranges.find(getIteratorDeclaration(*argument));
+                    if (range != ranges.end() && range->second.second == range->second.first->getNestingLevel())
                     {
-                        const std::string filename = outputFilename.substr(pos);
-                        outputFilename = std::string(output_path) + filename;
+                        declaration = range->second.first;
+                        break;
                     }
-                    else
+                }
+                if (!declaration) continue;
+
+                for (const auto argument : callExpr->arguments())
+                {
+                    const clang::Expr* expr = argument->IgnoreImplicit();
+                    if (const clang::CXXConstructExpr* const constructExpr = llvm::dyn_cast<clang::CXXConstructExpr>(expr))
                     {
-                        outputFilename.insert(pos != std::string::npos ? (pos + 1) : 0, "new_files/");
+                        if (constructExpr->getNumArgs() == 1) expr = constructExpr->getArg(0)->IgnoreImplicit();
                     }
 
-                    std::ofstream out(outputFilename);
-                    if (out)
+                    const clang::LambdaExpr* const lambdaExpr = llvm::dyn_cast<clang::LambdaExpr>(expr->IgnoreParens());
+                    if (!lambdaExpr) continue;
+
+                    // element parameters: the element type itself or 'auto'
+                    for (const auto param : lambdaExpr->getCallOperator()->parameters())
                     {
-                        out << outputStream.str();
-                        out.close();
+                        const clang::QualType type = param->getType().getNonReferenceType();
+                        if (context.hasSameUnqualifiedType(type, declaration->elementDataType) || type->getAs<clang::TemplateTypeParmType>() || type->getContainedAutoType())
+                        {
+                            ranges[param] = std::make_pair(declaration, declaration->getNestingLevel() + 1);
+                            modifyElementReference(*param, declaration, modifiedVariables, outputFiles, context);
+                        }
                     }
-                    else
-                    {
-                        std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
-                    }    
                 }
+            }
+        }
 
-                //////////////////////////////////////////////////////////////////////////////////////////////////////////
-                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 'std::abs(v[i])' -> 'abs(v[i])': the overloads for 'complex_proxy' are found through argument dependent lookup only
+        void modifyComplexMathCalls(std::set<clang::FileID>& outputFiles, clang::ASTContext& context)
+        {
+            using namespace clang::ast_matchers;
 
-                // generate proxy class definition
-                generateProxyClassDefinition(target, proxyClassCreator, std::string("// my header\n"));
+            const std::vector<std::string>& functionNames = getComplexProxyFunctionNames();
+            std::vector<std::pair<const clang::CallExpr*, clang::NestedNameSpecifierLoc>> calls;
 
-                // process functions that are not within the class
-                for (auto it = functionsWithTargetParameters.begin(); it != functionsWithTargetParameters.end(); )
+            Matcher matcher;
+            matcher.addMatcher(callExpr(unless(isExpansionInSystemHeader()), unless(isInTemplateInstantiation())).bind("call"),
+                [&calls, &functionNames] (const MatchFinder::MatchResult& result) mutable
                 {
-                    const auto& function = *it;
-                    const clang::FileID fileId = context.getSourceManager().getFileID(function->getLocation());
-                    if (fileId == target->fileId)
+                    const clang::CallExpr* const callExpr = result.Nodes.getNodeAs<clang::CallExpr>("call");
+                    if (!callExpr || callExpr->getNumArgs() != 1) return;
+
+                    // the callee is unresolved if the argument is type dependent
+                    const clang::Expr* const callee = callExpr->getCallee()->IgnoreParenImpCasts();
+                    clang::NestedNameSpecifierLoc qualifierLoc;
+                    std::string functionName;
+                    if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(callee))
                     {
-                        const clang::FunctionTemplateDecl* templateFunctionDecl = function->getDescribedFunctionTemplate();
+                        if (!declRefExpr->getDecl()->isInStdNamespace()) return;
+
+                        qualifierLoc = declRefExpr->getQualifierLoc();
+                        functionName = declRefExpr->getNameInfo().getAsString();
+                    }
+                    else if (const clang::UnresolvedLookupExpr* const lookupExpr = llvm::dyn_cast<clang::UnresolvedLookupExpr>(callee))
+                    {
+                        const clang::NamespaceDecl* const namespaceDecl = (lookupExpr->getQualifier() ? lookupExpr->getQualifier()->getAsNamespace() : nullptr);
+                        if (!namespaceDecl || !namespaceDecl->isStdNamespace()) return;
+
+                        qualifierLoc = lookupExpr->getQualifierLoc();
+                        functionName = lookupExpr->getName().getAsString();
+                    }
+
+                    if (!qualifierLoc || std::find(functionNames.begin(), functionNames.end(), functionName) == functionNames.end()) return;
+
+                    calls.push_back(std::make_pair(callExpr, qualifierLoc));
+                });
+            matcher.run(context);
+
+            const clang::SourceManager& sourceManager = context.getSourceManager();
+            std::set<clang::SourceLocation> modifiedCalls;
+
+            for (const auto& call : calls)
+            {
+                // 'v[i][j]', 'row[j]', 'z' with 'row' and 'z' being range-based for loop variables or lambda parameters
+                const clang::Expr* expr = call.first->getArg(0)->IgnoreParenImpCasts();
+                std::uint32_t numSubscripts = 0;
+                while (true)
+                {
+                    if (const clang::ArraySubscriptExpr* const subscriptExpr = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr))
+                    {
+                        expr = subscriptExpr->getBase()->IgnoreParenImpCasts();
+                    }
+                    else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(expr))
+                    {
+                        if (operatorCallExpr->getOperator() != clang::OO_Subscript) break;
+
+                        expr = operatorCallExpr->getArg(0)->IgnoreParenImpCasts();
+                    }
+                    else
+                    {
+                        break;
+                    }
+
+                    ++numSubscripts;
+                }
+
+                const clang::ValueDecl* const decl = getReferencedDeclaration(*expr);
+                const auto range = elementRanges.find(decl);
+                if (range == elementRanges.end()) continue;
+
+                const Declaration* const declaration = range->second.first;
+                if (getBuiltinProxyName(declaration->elementDataType) != std::string("complex")) continue;
+                if ((range->second.second + numSubscripts) != (declaration->getNestingLevel() + 1)) continue;
+
+                const clang::SourceLocation qualifierBegin = call.second.getBeginLoc();
+                if (qualifierBegin.isMacroID() || !modifiedCalls.insert(qualifierBegin).second) continue;
+
+                const clang::FileID fileId = sourceManager.getFileID(qualifierBegin);
+                const std::size_t offset = sourceManager.getFileOffset(qualifierBegin);
+
+                rewriter.getEditBuffer(fileId).RemoveText(offset, sourceManager.getFileOffset(call.second.getEndLoc()) + 2 - offset);
+                outputFiles.insert(fileId);
+            }
+        }
+
+        bool matchDeclarations(clang::ASTContext& context)
+        {
+            using namespace clang::ast_matchers;
+
+            Matcher matcher;
+
+            declarations.clear();
+            numInstantiations.clear();
+            indexSpaces.clear();
+
+            for (const auto& descriptor : containerDescriptors)
+            {
+                const std::string containerName = descriptor.name;
+
+                matcher.addMatcher(varDecl(hasType(cxxRecordDecl(hasName(containerName)))).bind("varDecl"),
+                    [&context, this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::VarDecl* const decl = result.Nodes.getNodeAs<clang::VarDecl>("varDecl"))
+                        {
+                            addDeclaration(new ContainerDeclaration(ContainerDeclaration::make(*decl, context, containerDescriptors)));
+                        }
+                    });
+
+                // data members: containers in system headers are never transformed, and template instantiations share the declaration of their pattern (unless its type is dependent)
+                matcher.addMatcher(fieldDecl(allOf(hasType(cxxRecordDecl(hasName(containerName))), unless(isExpansionInSystemHeader()))).bind("fieldDecl"),
+                    [&context, this] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::FieldDecl* const decl = result.Nodes.getNodeAs<clang::FieldDecl>("fieldDecl"))
+                        {
+                            if (isInstantiatedDeclaration(*decl) && !hasDependentPattern(*decl)) return;
+
+                            addDeclaration(new ContainerDeclaration(ContainerDeclaration::make(*decl, context, containerDescriptors)));
+                        }
+                    });
+            }
+
+            matcher.addMatcher(varDecl(hasType(constantArrayType())).bind("constArrayDecl"),
+                [&context, this] (const MatchFinder::MatchResult& result) mutable
+                {
+                    if (const clang::VarDecl* const decl = result.Nodes.getNodeAs<clang::VarDecl>("constArrayDecl"))
+                    {
+                        addDeclaration(new ConstantArrayDeclaration(ConstantArrayDeclaration::make(*decl, context)));
+                    }
+                });
+
+            matcher.addMatcher(fieldDecl(allOf(hasType(constantArrayType()), unless(isExpansionInSystemHeader()), unless(isInstantiated()))).bind("constArrayFieldDecl"),
+                [&context, this] (const MatchFinder::MatchResult& result) mutable
+                {
+                    if (const clang::FieldDecl* const decl = result.Nodes.getNodeAs<clang::FieldDecl>("constArrayFieldDecl"))
+                    {
+                        addDeclaration(new ConstantArrayDeclaration(ConstantArrayDeclaration::make(*decl, context)));
+                    }
+                });
+
+            // heap arrays: pointers and std::unique_ptr<T[]>
+            matcher.addMatcher(varDecl(allOf(anyOf(hasType(hasCanonicalType(pointerType())), hasType(cxxRecordDecl(hasName("unique_ptr")))), hasInitializer(anything()), unless(isExpansionInSystemHeader()))).bind("heapArrayDecl"),
+                [&context, this] (const MatchFinder::MatchResult& result) mutable
+                {
+                    if (const clang::VarDecl* const decl = result.Nodes.getNodeAs<clang::VarDecl>("heapArrayDecl"))
+                    {
+                        addDeclaration(new HeapArrayDeclaration(HeapArrayDeclaration::make(*decl, context)));
+                    }
+                });
+
+            matcher.run(context);
+
+            checkHeapArrayDeclarations(context);
+
+            mergeTemplateInstantiations(context);
+
+            // data members of proxy class targets are part of the generated proxy classes: they are not transformed themselves
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                proxyClassTargetNames.clear();
+
+                for (const auto& declaration : declarations)
+                {
+                    if (getBuiltinProxyName(declaration->elementDataType) != std::string("")) continue;
+
+                    proxyClassTargetNames.insert(declaration->elementDataTypeName);
+                    addNestedProxyClassTargetNames(declaration->elementDataType->getAsCXXRecordDecl());
+                }
+
+                for (auto it = declarations.begin(); it != declarations.end(); )
+                {
+                    const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(&((*it)->decl));
+
+                    if (fieldDecl && proxyClassTargetNames.find(fieldDecl->getParent()->getNameAsString()) != proxyClassTargetNames.end())
+                    {
+                        delete *it;
+                        it = declarations.erase(it);
+                        changed = true;
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+
+            // the buffer types are not known yet: the parameters are needed for the analyses only
+            {
+                std::map<const Declaration*, std::string> bufferTypeNames;
+                std::set<const Declaration*> stridedDeclarations;
+                for (const auto& declaration : declarations)
+                {
+                    bufferTypeNames[declaration] = declaration->decl.getNameAsString();
+                    stridedDeclarations.insert(declaration);
+                }
+
+                propagatedParameters = ParameterPropagation(declarations, bufferTypeNames, stridedDeclarations, context).getPropagatedParameters();
+            }
+
+            findJaggedDeclarations(context);
+
+            findGrowableDeclarations(context);
+
+            propagateParameters(context);
+
+            for (const auto& declaration : declarations)
+            {
+                usesBuiltinProxies |= (getBuiltinProxyName(declaration->elementDataType) != std::string(""));
+            }
+
+            return (declarations.size() > 0);
+        }
+
+        bool findProxyClassTargets(clang::ASTContext& context)
+        {
+            using namespace clang::ast_matchers;
+
+            Matcher matcher;
+
+            for (auto name : proxyClassTargetNames)
+            {
+                // template class declarations
+                matcher.addMatcher(classTemplateDecl(hasName(name)).bind("classTemplateDeclaration"),
+                    [this, &context] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::ClassTemplateDecl* const decl = result.Nodes.getNodeAs<clang::ClassTemplateDecl>("classTemplateDeclaration"))
+                        {
+                            if (decl->isThisDeclarationADefinition()) return;
+
+                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
+                            
+                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
+                                sourceLocationString.find("usr/include") != std::string::npos) return;
+
+                            proxyClassTargets.emplace_back(new TemplateClassMetaData(*decl, false));
+                        }
+                    });
+                
+                // template class definitions
+                matcher.addMatcher(classTemplateDecl(hasName(name)).bind("classTemplateDefinition"),
+                    [this, &context] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::ClassTemplateDecl* const decl = result.Nodes.getNodeAs<clang::ClassTemplateDecl>("classTemplateDefinition"))
+                        {
+                            if (!decl->isThisDeclarationADefinition()) return;
+
+                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
+                            
+                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
+                                sourceLocationString.find("usr/include") != std::string::npos) return;
+                            
+                            for (auto& target : proxyClassTargets)
+                            {
+                                if (target->addDefinition(*(decl->getTemplatedDecl()))) return;
+                            }
+                                       
+                            // not found
+                            proxyClassTargets.emplace_back(new TemplateClassMetaData(*decl, true));
+                            proxyClassTargets.back()->addDefinition(*(decl->getTemplatedDecl()));
+                        }
+                    });
+                
+                // template class partial specialization
+                matcher.addMatcher(classTemplatePartialSpecializationDecl(hasName(name)).bind("classTemplatePartialSpecialization"),
+                    [this, &context] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::ClassTemplatePartialSpecializationDecl* const decl = result.Nodes.getNodeAs<clang::ClassTemplatePartialSpecializationDecl>("classTemplatePartialSpecialization"))
+                        {                         
+                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
+                            
+                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
+                                sourceLocationString.find("usr/include") != std::string::npos) return;
+
+                            const bool isInstantiated = isThisClassInstantiated(decl);
+                            
+                            for (std::size_t i = 0; i < proxyClassTargets.size(); ++i)
+                            {
+                                if (proxyClassTargets[i]->addDefinition(*decl, true, isInstantiated)) return;
+                            }
+                        }
+                    });
+                    
+                // standard C++ classes
+                matcher.addMatcher(cxxRecordDecl(allOf(hasName(name), unless(isTemplateInstantiation()))).bind("c++Class"),
+                    [this, &context] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::CXXRecordDecl* const decl = result.Nodes.getNodeAs<clang::CXXRecordDecl>("c++Class"))
+                        {
+                            const std::string name = decl->getNameAsString();
+                            const bool isDefinition = decl->isThisDeclarationADefinition();
+
+                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
+                            
+                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
+                                sourceLocationString.find("usr/include") != std::string::npos) return;
+
+                            for (auto& target : proxyClassTargets)
+                            {
+                                // if it is a specialization of a template class, skip this class definition!
+                                // note: if there are templated classes with that name, they (should) have been found by any previous matcher
+                                if (target->name == name)
+                                {
+                                    if (target->isTemplated()) return;
+
+                                    if (isDefinition && target->addDefinition(*decl, false)) return;
+                                }
+                            }
+
+                            proxyClassTargets.emplace_back(new CXXClassMetaData(*decl, isDefinition));
+                            if (isDefinition)
+                            {
+                                proxyClassTargets.back()->addDefinition(*decl, false);
+                            }
+                        }
+                    });
+            }
+
+            matcher.run(context);
+
+            return (proxyClassTargets.size() > 0);
+        }
+        
+        static std::string getTemplateArgumentString(const clang::TemplateArgument& argument, const clang::PrintingPolicy& policy)
+        {
+            std::string argumentString;
+            llvm::raw_string_ostream stream(argumentString);
+            argument.print(policy, stream);
+
+            return stream.str();
+        }
+
+        // value of an integral template argument or of a non-dependent constant expression
+        static bool getIntegralTemplateArgument(const clang::TemplateArgument& argument, const clang::ASTContext& context, llvm::APSInt& value)
+        {
+            if (argument.getKind() == clang::TemplateArgument::ArgKind::Integral)
+            {
+                value = argument.getAsIntegral();
+                return true;
+            }
+
+            if (argument.getKind() == clang::TemplateArgument::ArgKind::Expression)
+            {
+                const clang::Expr* const expr = argument.getAsExpr();
+                return (!expr->isValueDependent() && expr->isIntegerConstantExpr(value, context));
+            }
+
+            return false;
+        }
+
+        // name of the template parameter an argument of a partial specialization refers to, e.g. 'T' in 'vec<T, 3>' (empty if it is no template parameter)
+        static std::string getTemplateParameterName(const clang::TemplateArgument& argument, const clang::TemplateParameterList& templateParameters)
+        {
+            if (argument.getKind() == clang::TemplateArgument::ArgKind::Type)
+            {
+                if (const clang::TemplateTypeParmType* const parameter = argument.getAsType()->getAs<clang::TemplateTypeParmType>())
+                {
+                    if (parameter->getIndex() < templateParameters.size()) return templateParameters.getParam(parameter->getIndex())->getNameAsString();
+                }
+            }
+            else if (argument.getKind() == clang::TemplateArgument::ArgKind::Expression)
+            {
+                if (const clang::DeclRefExpr* const declRefExpr = llvm::dyn_cast<clang::DeclRefExpr>(argument.getAsExpr()->IgnoreParenImpCasts()))
+                {
+                    if (llvm::isa<clang::NonTypeTemplateParmDecl>(declRefExpr->getDecl())) return declRefExpr->getDecl()->getNameAsString();
+                }
+            }
+
+            return std::string("");
+        }
+
+        // template arguments of a record type, e.g. {double, 3} for the type 'vec<double, 3>' of a nested record field
+        static std::vector<clang::TemplateArgument> getTemplateArguments(const clang::QualType& type)
+        {
+            std::vector<clang::TemplateArgument> arguments;
+
+            if (const clang::TemplateSpecializationType* const templateType = type->getAs<clang::TemplateSpecializationType>())
+            {
+                arguments.assign(templateType->getArgs(), templateType->getArgs() + templateType->getNumArgs());
+            }
+            else if (const clang::ClassTemplateSpecializationDecl* const specialization = llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(type->getAsCXXRecordDecl()))
+            {
+                const clang::TemplateArgumentList& argumentList = specialization->getTemplateArgs();
+                for (std::uint32_t i = 0; i < argumentList.size(); ++i)
+                {
+                    arguments.push_back(argumentList[i]);
+                }
+            }
+
+            return arguments;
+        }
+
+        // does the partial specialization match the template arguments? its template parameters are bound to the corresponding arguments
+        static bool matchPartialSpecialization(const clang::ClassTemplatePartialSpecializationDecl& partialSpecialization, const std::vector<clang::TemplateArgument>& arguments, const clang::ASTContext& context, std::map<std::string, std::string>& templateArguments)
+        {
+            const clang::TemplateArgumentList& patternArguments = partialSpecialization.getTemplateArgs();
+            if (patternArguments.size() != arguments.size()) return false;
+
+            templateArguments.clear();
+            for (std::uint32_t i = 0; i < arguments.size(); ++i)
+            {
+                const clang::TemplateArgument& pattern = patternArguments[i];
+                const std::string parameterName = getTemplateParameterName(pattern, *partialSpecialization.getTemplateParameters());
+
+                if (parameterName != std::string(""))
+                {
+                    const std::string argument = getTemplateArgumentString(arguments[i], context.getPrintingPolicy());
+                    const auto binding = templateArguments.insert(std::make_pair(parameterName, argument));
+                    if (!binding.second && binding.first->second != argument) return false;
+
+                    continue;
+                }
+
+                llvm::APSInt patternValue, value;
+                if (getIntegralTemplateArgument(pattern, context, patternValue))
+                {
+                    if (!getIntegralTemplateArgument(arguments[i], context, value) || llvm::APSInt::compareValues(patternValue, value) != 0) return false;
+                }
+                else if (pattern.getKind() == clang::TemplateArgument::ArgKind::Type && arguments[i].getKind() == clang::TemplateArgument::ArgKind::Type)
+                {
+                    if (!context.hasSameType(pattern.getAsType(), arguments[i].getAsType())) return false;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        const ClassMetaData::Definition* getNestedDefinition(const ClassMetaData::Field& field, std::map<std::string, std::string>* templateArguments = nullptr) const
+        {
+            if (!field.isNestedRecord) return nullptr;
+
+            return getDefinition(field.nestedRecordName, field.decl.getType(), field.decl.getASTContext(), templateArguments);
+        }
+
+        // definition of the record type 'type': the partial specialization that matches its template arguments, otherwise the primary template.
+        // 'templateArguments' maps the template parameters of that definition to the arguments, e.g. 'T' -> 'double' for 'vec<double, 3>' and 'vec<T, 3>'
+        const ClassMetaData::Definition* getDefinition(const std::string& recordName, const clang::QualType& type, const clang::ASTContext& context, std::map<std::string, std::string>* templateArguments = nullptr) const
+        {
+            const std::vector<clang::TemplateArgument> arguments = getTemplateArguments(type);
+            std::map<std::string, std::string> bindings;
+
+            for (const auto& target : proxyClassTargets)
+            {
+                if (target->name != recordName || !target->containsProxyClassCandidates) continue;
+
+                const ClassMetaData::Definition* primaryDefinition = nullptr;
+                for (const auto& definition : target->getDefinitions())
+                {
+                    if (!definition.isTemplatePartialSpecialization)
+                    {
+                        primaryDefinition = &definition;
+                    }
+                    else if (const clang::ClassTemplatePartialSpecializationDecl* const partialSpecialization = llvm::dyn_cast<clang::ClassTemplatePartialSpecializationDecl>(&definition.decl))
+                    {
+                        if (matchPartialSpecialization(*partialSpecialization, arguments, context, bindings))
+                        {
+                            if (templateArguments) *templateArguments = bindings;
+
+                            return &definition;
+                        }
+                    }
+                }
+
+                if (primaryDefinition)
+                {
+                    if (templateArguments)
+                    {
+                        const auto& templateParameters = primaryDefinition->declaration.templateParameters;
+
+                        templateArguments->clear();
+                        for (std::size_t i = 0; i < std::min(templateParameters.size(), arguments.size()); ++i)
+                        {
+                            (*templateArguments)[templateParameters[i].name] = getTemplateArgumentString(arguments[i], context.getPrintingPolicy());
+                        }
+                    }
+
+                    return primaryDefinition;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // proxy class targets with nested records that do not have a proxy class themselves are sorted out
+        void checkNestedProxyClassTargets()
+        {
+            bool sortedOut = true;
+
+            while (sortedOut)
+            {
+                sortedOut = false;
+
+                for (auto& target : proxyClassTargets)
+                {
+                    if (!target->containsProxyClassCandidates) continue;
+
+                    for (const auto& definition : target->getDefinitions())
+                    {
+                        for (const auto& field : definition.fields)
+                        {
+                            if (field.isNestedRecord && !getNestedDefinition(field))
+                            {
+                                std::cerr << "warning: " << target->name << " has field '" << field.name << "' of non-transformable type " << field.typeName << " -> not transformed" << std::endl;
+                                target->containsProxyClassCandidates = false;
+                                sortedOut = true;
+                                break;
+                            }
+                        }
+
+                        if (!target->containsProxyClassCandidates) break;
+                    }
+                }
+            }
+        }
+
+        std::string generateProxyClassDeclaration(const ClassMetaData::Declaration& declaration)
+        {
+            const std::string indent(declaration.indent.value, ' ');
+            const std::string extIndent(declaration.indent.value + declaration.indent.increment, ' ');
+            std::stringstream proxyClassDeclaration;
+
+            proxyClassDeclaration << indent << "namespace " << proxyNamespace << "\n";
+            proxyClassDeclaration << indent << "{\n";
+            if (declaration.templateParameters.size())
+            {
+                const clang::SourceManager& sourceManager = declaration.getSourceManager();
+                const std::string parameterList = dumpSourceRangeToString(declaration.templateParameterListSourceRange, sourceManager);
+
+                proxyClassDeclaration << extIndent << parameterList << ">\n";
+            }
+            proxyClassDeclaration << extIndent << (declaration.isStruct ? "struct " : "class ") << declaration.name << "_proxy;\n";
+            proxyClassDeclaration << indent << "}\n\n";
+
+            return proxyClassDeclaration.str();
+        }
+
+        std::string generateProxyClassUsingStmt(const ClassMetaData::Definition& definition)
+        {
+            const Indentation insideClassIndent = definition.declaration.indent + 1;
+            const std::string indent(insideClassIndent.value, ' ');
+            std::stringstream usingStmt;
+
+            usingStmt << indent << "using type = " << definition.name << definition.templateParameterString << ";\n\n";
+            usingStmt << indent << "using proxy_type = typename " << definition.declaration.namespaceString << proxyNamespace << "::" << definition.name << "_proxy";
+            usingStmt << definition.templateParameterString << ";\n";
+
+            return usingStmt.str();
+        }
+
+        std::string generateConstructorInitializerList(const ClassMetaData::Definition& definition, const std::string rhs = std::string("rhs"), const Indentation indentation = Indentation(0))
+        {
+            const std::string indent(indentation.value, ' ');
+
+            // array fields are copied element-wise in the constructor body, fields without stream are value initialized
+            std::vector<std::string> fieldNames;
+            std::vector<bool> isDead;
+            for (const auto& field : definition.fields)
+            {
+                if (!field.isArray || isDeadField(field.decl))
+                {
+                    fieldNames.push_back(field.name);
+                    isDead.push_back(isDeadField(field.decl));
+                }
+            }
+
+            if (const std::uint32_t numInitializers = fieldNames.size())
+            {
+                std::stringstream initializerList;
+
+                initializerList << indent << ":\n";
+                for (std::uint32_t i = 0; i < numInitializers; ++i)
+                {
+                    const std::string fieldName = fieldNames[i];
+                    initializerList << indent << fieldName << "(" << (isDead[i] ? std::string("") : (rhs + std::string(".") + fieldName));
+                    initializerList << ((i + 1) < numInitializers ? "),\n" : ")\n");
+                }
+
+                return initializerList.str();
+            }
+            
+            return std::string("");
+        }
+
+        std::string generateArrayFieldCopy(const ClassMetaData::Definition& definition, const std::string rhs = std::string("rhs"), const Indentation indentation = Indentation(0))
+        {
+            const std::string indent(indentation.value, ' ');
+            std::stringstream arrayFieldCopy;
+
+            for (const auto& field : definition.fields)
+            {
+                if (!field.isArray || isDeadField(field.decl)) continue;
+
+                arrayFieldCopy << indent << "for (std::size_t i = 0; i < " << field.arrayExtent << "; ++i) " << field.name << "[i] = " << rhs << "." << field.name << "[i];\n";
+            }
+
+            return arrayFieldCopy.str();
+        }
+
+        std::string generateConstructorClassFromProxyClass(const ClassMetaData::Definition& definition)
+        {
+            const Indentation insideClassIndent = definition.declaration.indent + 1;
+            const std::string indent(insideClassIndent.value, ' ');
+            std::stringstream constructorDefinition;
+
+            constructorDefinition << indent;
+
+            if (definition.hasCopyConstructor)
+            {
+                const auto& constructor = definition.constructors[definition.indexCopyConstructor];
+                const clang::ParmVarDecl* const parameter = constructor.decl.getParamDecl(0); // never nullptr
+
+                if (constructor.isTemplatedConstructor)
+                {
+                    constructorDefinition << dumpSourceRangeToString(constructor.templateSignatureSourceRange, definition.getSourceManager());
+                }
+                constructorDefinition << definition.name << "(const " << proxyNamespace << "::" << definition.name << "_proxy";
+                if (constructor.isTemplatedConstructor)
+                {
+                    const internal::ClassMetaData::FunctionArgument argument(*parameter, &definition);
+                    constructorDefinition << argument.templateParameters;
+                }
+                constructorDefinition << "& ";
+                
+                // dump the definition of the copy constructor starting at the parameter name
+                const clang::SourceRange everythingFromParmVarDeclName(parameter->getEndLoc(), constructor.decl.getEndLoc());
+                constructorDefinition << dumpSourceRangeToString(everythingFromParmVarDeclName, definition.getSourceManager());
+                if (constructor.decl.hasBody())
+                {
+                    constructorDefinition << "}";
+                }
+            }
+            else
+            {
+                constructorDefinition << definition.name << "(const " << proxyNamespace << "::" << definition.name << "_proxy& other)\n";
+                constructorDefinition << generateConstructorInitializerList(definition, std::string("other"), insideClassIndent + 1);
+
+                const std::string arrayFieldCopy = generateArrayFieldCopy(definition, std::string("other"), insideClassIndent + 1);
+                if (arrayFieldCopy.length())
+                {
+                    constructorDefinition << indent << "{\n" << arrayFieldCopy << indent << "}";
+                }
+                else
+                {
+                    constructorDefinition << indent << "{ ; }";
+                }
+            }
+            constructorDefinition << "\n";
+
+            return constructorDefinition.str();
+        }
+
+        void modifyMethodSignature(const ClassMetaData::Definition& definition, const ClassMetaData::Function& method, Rewriter& rewriter, const std::string proxyNamespace, const std::string targetNamespace, const bool returnProxyType = false)
+        {
+            clang::ASTContext& context = definition.declaration.getASTContext();
+            const clang::SourceManager& sourceManager = definition.declaration.getSourceManager();
+            const clang::FileID fileId = definition.declaration.fileId;
+            const Indentation insideClassIndent = definition.declaration.indent + 1;
+            const std::string indent(insideClassIndent.value, ' ');
+            const std::string extIndent((insideClassIndent + 1).value, ' ');
+            const std::string proxyTypeName = proxyNamespace + method.className + std::string("_proxy");
+            const std::string targetTypeName = targetNamespace + method.className;
+
+            if (method.isMacroExpansion)
+            {
+                std::string macroString = dumpSourceRangeToString(getExpansionSourceRange(method.sourceRange, context), sourceManager);                            
+                std::string proxyMacroString = macroString;
+                if (findAndReplace(macroString, method.className, targetTypeName, true, true))
+                {
+                    rewriter.replace(getExpansionSourceRange(method.sourceRange, context), macroString);
+                }
+                if (findAndReplace(proxyMacroString, method.className, proxyTypeName, true, true))
+                {
+                    rewriter.insert(getNextLine(getExpansionSourceLocation(method.sourceRange.getEnd(), context), context), indent + proxyMacroString + std::string("\n"));
+                }
+                
+                // adapt return type
+                if (returnProxyType && method.returnsClassTypeReference)
+                {
+                    const clang::SourceLocation beginLoc = getSpellingSourceLocation(method.returnTypeSourceRange.getBegin(), context);
+                    const clang::SourceLocation endLoc = getSpellingSourceLocation(method.bodySourceRange.getBegin(), context).getLocWithOffset(-1);
+                    std::string selection = dumpSourceRangeToString({beginLoc, endLoc}, sourceManager);
+                    findAndReplace(selection, method.className, proxyTypeName, true, true);
+
+                    rewriter.replace({beginLoc, endLoc}, selection);
+                }
+            }
+            else
+            {
+                // duplicate the original function definition and insert it only if we have to change argument types in the orignal definition
+                // NOTE 1: this must not be the case if the class-type arguments have default values!
+                const std::string originalFunctionDefinition = dumpSourceRangeToString(method.extendedSourceRange, sourceManager);
+                bool insertOriginalDefinition = false;
+
+                // create new function
+                std::stringstream functionSignature;
+                bool insertNewDefinition = false;
+
+                if (method.returnsClassType && returnProxyType)
+                {
+                    std::string tmp = method.signatureString[0];
+                    findAndReplace(tmp, method.className, proxyTypeName, true, true);
+                    functionSignature << tmp << "(";
+                }
+                else
+                {
+                    functionSignature << method.signatureString[0] << "(";
+                }
+
+                for (std::uint32_t i = 0; i < method.arguments.size(); ++i)
+                {
+                    const auto& argument = method.arguments[i];
+
+                    if (argument.isClassType)
+                    {
+                        std::string targetArgumentTypeName = argument.elementTypeName;
+                        std::string proxyArgumentTypeName = targetArgumentTypeName;
+                        findAndReplace(targetArgumentTypeName, method.className, targetTypeName, true, true);
+                        findAndReplace(proxyArgumentTypeName, method.className, proxyTypeName, true, true);
+                        
+                        std::string argumentStringPostfix = (method.isFunctionTemplate ? argument.templateParameters : std::string("")) +
+                            std::string(argument.isRReference ? "&&" : "") + 
+                            std::string(argument.isLReference ? "&" : "") + 
+                            std::string(argument.isPointer ? "* " : " ") + 
+                            argument.name;
+                        std::string targetArgumentString = (argument.isConst ? "const " : "") + targetArgumentTypeName + argumentStringPostfix;
+                        std::string proxyArgumentString = (argument.isConst ? "const " : "") + proxyArgumentTypeName + argumentStringPostfix;
+
+                        if (argument.decl.hasDefaultArg())
+                        {
+                            std::string originalArgumentString = dumpSourceRangeToString(method.signature[i + 1], sourceManager);
+
+                            rewriter.replace(argument.sourceRange, targetArgumentString + std::string(" ") + originalArgumentString.substr(originalArgumentString.rfind('=')));
+                            insertNewDefinition = true;
+                        }
+                        else
+                        {
+                            // 1. replace argument by proxy argument in original function
+                            rewriter.replace(argument.sourceRange, proxyArgumentString);
+                            insertOriginalDefinition = true;
+                        }
+
+                        // 2. create proxy argument in new function
+                        functionSignature << (i > 0 ? ", " : "") << proxyArgumentString;
+                    }
+                    else
+                    {
+                        functionSignature << (i > 0 ? ", " : "") << dumpSourceRangeToString(method.signature[i + 1], sourceManager);
+                    }
+
+                    if ((i + 1) ==  method.arguments.size())
+                    {
+                        functionSignature << (method.isConst ? ") const\n" : ")\n");
+                    }
+                }
+                
+                if (insertNewDefinition)
+                {
+                    rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), std::string("\n") + indent + functionSignature.str());
+                    rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), indent + dumpSourceRangeToString(method.extendedBodySourceRange, sourceManager));
+                }
+
+                if (insertOriginalDefinition)
+                {
+                    if (returnProxyType)
+                    {
+                        if (method.returnsClassTypeReference)
+                        {
+                            std::string tmp = dumpSourceRangeToString(method.signatureSourceRange, sourceManager);
+                            findAndReplace(tmp, method.className, proxyTypeName, false, true);
+                            rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), std::string("\n") + indent + tmp);
+                            rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), dumpSourceRangeToString(method.extendedBodySourceRange, sourceManager));
+                        }
+                    }
+                    else
+                    {
+                        rewriter.insert(getNextLine(method.sourceRange.getEnd(), context), std::string("\n") + indent + originalFunctionDefinition);
+                    }
+                }
+            }
+        }
+
+
+        void modifyOriginalSourceCode(const std::unique_ptr<ClassMetaData>& candidate, Rewriter& rewriter)
+        {
+            if (!candidate.get()) return;
+
+            const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
+            clang::ASTContext& context = declaration.getASTContext();
+            const clang::SourceManager& sourceManager = declaration.getSourceManager();
+            const clang::FileID fileId = declaration.fileId;
+
+            // insert proxy class forward declaration
+            rewriter.insert(getBeginOfLine(declaration.sourceRange.getBegin(), context), generateProxyClassDeclaration(declaration));
+            
+            // add constructors with proxy class arguments
+            const std::vector<ClassMetaData::Definition>& definitions = candidate->getDefinitions();
+            for (const auto& definition : definitions)
+            {
+                const Indentation insideClassIndent = definition.declaration.indent + 1;
+                const std::string indent(insideClassIndent.value, ' ');
+                const std::string extIndent((insideClassIndent + 1).value, ' ');
+
+                // in case of a C++ class, there must be at least one public access specifier
+                // as we require proxy class candidates have at least one public field!
+                clang::SourceLocation sourceLocation;
+
+                if (definition.indexPublicAccessSpecifiers.size() > 0)
+                {
+                    sourceLocation = definition.accessSpecifiers[definition.indexPublicAccessSpecifiers[0]].scopeBegin;
+
+                }
+                else if (definition.declaration.isStruct)
+                {
+                    sourceLocation = definition.innerSourceRange.getBegin();
+                }
+
+                // insert using statement into class definition
+                rewriter.insert(sourceLocation, generateProxyClassUsingStmt(definition));
+                
+                // insert constructor
+                if (definition.hasCopyConstructor)
+                {
+                    sourceLocation = getNextLine(definition.constructors[definition.indexCopyConstructor].sourceRange.getEnd(), context);
+                }
+                else if (definition.indexPublicConstructors.size() > 0)
+                {
+                    sourceLocation = getNextLine(definition.constructors[definition.indexPublicConstructors.back()].sourceRange.getEnd(), context);
+                }
+                rewriter.insert(sourceLocation, generateConstructorClassFromProxyClass(definition));
+
+                // insert methods that have the class type as argument type
+                for (const auto& method : definition.cxxMethods)
+                {
+                    if (method.hasClassTypeArguments)
+                    { 
+                        modifyMethodSignature(definition, method, rewriter, proxyNamespace + std::string("::"), std::string(""));
+                    }
+                }
+            }
+            
+            // insert include line outside the outermost namespace or after the last class definition if there is no namespace
+            std::stringstream includeLine;
+            includeLine << "\n#include \"autogen_" << candidate->name << "_proxy.hpp\"\n\n";
+            rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), includeLine.str());
+
+            // insert type traits
+            {
+                const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
+                
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), std::string("#include <common/traits.hpp>\n\n"));    
+                
+                const Indentation Indent = Indentation(declaration.indent.increment, declaration.indent.increment);
+                const std::string indent(Indent.value, ' ');
+                const Indentation ExtIndent = Indent + 1;
+                const std::string extIndent(ExtIndent.value, ' ');
+                const Indentation ExtExtIndent = ExtIndent + 1;
+                const std::string extExtIndent(ExtExtIndent.value, ' ');
+                std::string namespaceName;
+                for (const auto& thisNamespace : declaration.namespaces)
+                {
+                    namespaceName += (thisNamespace.name + std::string("::"));
+                }
+
+                
+                std::stringstream typeTraitsStream_1;
+                typeTraitsStream_1 << "namespace XXX_NAMESPACE\n{\n";
+                typeTraitsStream_1 << indent << "namespace internal\n";
+                typeTraitsStream_1 << indent << "{\n";
+                if (candidate->isTemplated())
+                {
+                    typeTraitsStream_1 << extIndent << "template " << declaration.templateParameterDeclString << "\n";
+                }
+                typeTraitsStream_1 << extIndent << "struct provides_proxy_type<";
+
+                std::stringstream typeTraitsStream_2;
+                typeTraitsStream_2 << extIndent << "{\n";
+                typeTraitsStream_2 << extExtIndent << "static constexpr bool value = true;\n";
+                typeTraitsStream_2 << extIndent << "};\n";
+                typeTraitsStream_2 << indent << "}\n";
+                typeTraitsStream_2 << "}\n";
+
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_1.str());
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), namespaceName + declaration.name + declaration.templateParameterString + std::string(">\n"));
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_2.str() + std::string("\n"));
+
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_1.str());
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), std::string("const ") + namespaceName + declaration.name + declaration.templateParameterString + std::string(">\n"));
+                rewriter.insert(getNextLine(candidate->bottomMostSourceLocation, context), typeTraitsStream_2.str());
+            }
+
+        }
+
+        // mapping of the fields of a proxy class candidate onto the streams of the buffer
+        struct StreamLayout
+        {
+            // fields that are never read get no stream and are not part of the proxy class
+            std::vector<bool> isLiveField;
+            std::vector<std::uint32_t> liveFieldIds;
+            // element type of each stream: array fields contribute one stream per element, nested records the streams of their own layout
+            std::vector<std::string> streamTypeNames;
+            // first stream and number of streams of each field
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> fieldStreams;
+            bool isHomogeneous = true;
+            // AoS records of fields that are accessed together (field ids): empty for a pure SoA layout
+            std::vector<std::vector<std::uint32_t>> fieldClusters;
+            // inhomogeneous streams share one allocation and are addressed through a single base pointer
+            bool isPacked = false;
+
+            std::uint32_t getStreamId(const std::uint32_t fieldId) const
+            {
+                return fieldStreams[fieldId].first;
+            }
+        };
+
+        // writes to a bit share a word with the bits of neighboring elements: bit packing is requested per field ('trafo:bit_packed'),
+        // as it must not be used for fields that are written concurrently for different elements
+        static bool isBitPackedField(const clang::FieldDecl& fieldDecl)
+        {
+            const clang::QualType type = fieldDecl.getType();
+
+            return (type->isBooleanType() && !type.isConstQualified() && getAnnotations(fieldDecl).count("bit_packed") > 0);
+        }
+
+        static bool isBitPackedField(const ClassMetaData::Field& field)
+        {
+            return isBitPackedField(field.decl);
+        }
+
+        // writes to bit-packed fields inside OpenMP parallel regions race with the writes to the neighboring elements (of the same word)
+        void checkBitPackedFieldWrites(clang::ASTContext& context) const
+        {
+            using namespace clang::ast_matchers;
+
+            std::set<const clang::FieldDecl*> reportedFields;
+
+            Matcher matcher;
+            matcher.addMatcher(memberExpr(unless(isExpansionInSystemHeader())).bind("bitPackedField"),
+                [&reportedFields, &context] (const MatchFinder::MatchResult& result) mutable
+                {
+                    const clang::MemberExpr* const memberExpr = result.Nodes.getNodeAs<clang::MemberExpr>("bitPackedField");
+                    const clang::FieldDecl* const fieldDecl = (memberExpr ? llvm::dyn_cast<clang::FieldDecl>(memberExpr->getMemberDecl()) : nullptr);
+                    if (!fieldDecl || !isBitPackedField(*fieldDecl)) return;
+
+                    const clang::Stmt* const parent = getParentIgnoringImplicitCode(*memberExpr, context);
+                    bool isWrite = false;
+                    if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast_or_null<clang::BinaryOperator>(parent))
+                    {
+                        isWrite = (binaryOperator->isAssignmentOp() && binaryOperator->getLHS()->IgnoreParenImpCasts() == memberExpr);
+                    }
+                    else if (const clang::UnaryOperator* const unaryOperator = llvm::dyn_cast_or_null<clang::UnaryOperator>(parent))
+                    {
+                        isWrite = unaryOperator->isIncrementDecrementOp();
+                    }
+
+                    if (isWrite && isInsideParallelRegion(*memberExpr, context) && reportedFields.insert(fieldDecl->getCanonicalDecl()).second)
+                    {
+                        std::cerr << "warning: bit-packed field " << fieldDecl->getNameAsString() << " is written inside a parallel region in " << memberExpr->getSourceRange().printToString(context.getSourceManager())
+                            << ": writes to neighboring elements race -> remove 'trafo:bit_packed' unless the elements of one thread cover whole words" << std::endl;
+                    }
+                });
+            matcher.run(context);
+        }
+
+        // narrowest integer type for values in [minValue, maxValue]
+        static std::string getNarrowestIntegerTypeName(const std::int64_t minValue, const std::int64_t maxValue, std::size_t& size)
+        {
+            if (minValue >= 0)
+            {
+                size = (maxValue <= 0xFF ? 1 : (maxValue <= 0xFFFF ? 2 : (maxValue <= 0xFFFFFFFF ? 4 : 8)));
+                return std::string("std::uint") + std::to_string(8 * size) + std::string("_t");
+            }
+
+            const std::int64_t maxAbsValue = std::max(-(minValue + 1), maxValue);
+            size = (maxAbsValue <= 0x7F ? 1 : (maxAbsValue <= 0x7FFF ? 2 : (maxAbsValue <= 0x7FFFFFFF ? 4 : 8)));
+            return std::string("std::int") + std::to_string(8 * size) + std::string("_t");
+        }
+
+        // storage type of enum fields, of integer fields annotated with a value range 'trafo:range=min:max'
+        // and of floating point fields annotated with a reduced precision 'trafo:storage=float|half|bfloat16'
+        // returns an empty string if the field is not narrowed
+        std::string getNarrowedStorageTypeName(const ClassMetaData::Field& field) const
+        {
+            if (!field.type || field.isConst || field.type->isDependentType()) return std::string("");
+
+            std::int64_t minValue = 0;
+            std::int64_t maxValue = 0;
+
+            if (const clang::EnumType* const enumType = field.type->getAs<clang::EnumType>())
+            {
+                const clang::EnumDecl* const enumDecl = enumType->getDecl();
+                if (!narrowEnums || !enumDecl || enumDecl->enumerator_begin() == enumDecl->enumerator_end()) return std::string("");
+
+                minValue = std::numeric_limits<std::int64_t>::max();
+                maxValue = std::numeric_limits<std::int64_t>::min();
+                for (const auto enumerator : enumDecl->enumerators())
+                {
+                    minValue = std::min(minValue, enumerator->getInitVal().getExtValue());
+                    maxValue = std::max(maxValue, enumerator->getInitVal().getExtValue());
+                }
+            }
+            else if (field.type->isIntegerType() && !field.type->isBooleanType())
+            {
+                const auto annotations = getAnnotations(field.decl);
+                const auto range = annotations.find("range");
+                if (range == annotations.end()) return std::string("");
+
+                // both bounds must be complete decimal numbers, e.g. 'trafo:range=0:4x' is rejected
+                const std::size_t pos = range->second.find(':');
+                const std::string minString = (pos != std::string::npos ? range->second.substr(0, pos) : std::string(""));
+                const std::string maxString = (pos != std::string::npos ? range->second.substr(pos + 1) : std::string(""));
+                char* minEnd = nullptr;
+                char* maxEnd = nullptr;
+
+                minValue = std::strtoll(minString.c_str(), &minEnd, 10);
+                maxValue = std::strtoll(maxString.c_str(), &maxEnd, 10);
+                if (minString.empty() || maxString.empty() || *minEnd != '\0' || *maxEnd != '\0' || minValue > maxValue)
+                {
+                    if (invalidAnnotationFields.insert(&field.decl).second)
+                    {
+                        std::cerr << "warning: invalid range annotation '" << range->second << "' of field " << field.name << " -> ignored" << std::endl;
+                    }
+                    return std::string("");
+                }
+            }
+            else if (field.type->isRealFloatingType())
+            {
+                const auto annotations = getAnnotations(field.decl);
+                const auto storage = annotations.find("storage");
+                if (storage == annotations.end()) return std::string("");
+
+                std::string storageTypeName("");
+                std::size_t size = 0;
+                if (storage->second == std::string("float"))
+                {
+                    storageTypeName = std::string("float");
+                    size = sizeof(float);
+                }
+                else if (storage->second == std::string("half") || storage->second == std::string("bfloat16"))
+                {
+                    // 16-bit formats are provided by the buffer runtime: no compiler support for _Float16 is required
+                    storageTypeName = std::string("XXX_NAMESPACE::") + storage->second;
+                    size = 2;
+                }
+                else
+                {
+                    if (invalidAnnotationFields.insert(&field.decl).second)
+                    {
+                        std::cerr << "warning: invalid storage annotation '" << storage->second << "' of field " << field.name << " -> ignored" << std::endl;
+                    }
+                    return std::string("");
+                }
+
+                const std::size_t originalSize = field.decl.getASTContext().getTypeSizeInChars(field.decl.getType()).getQuantity();
+
+                return (size < originalSize ? storageTypeName : std::string(""));
+            }
+            else
+            {
+                return std::string("");
+            }
+
+            std::size_t size = 0;
+            const std::string storageTypeName = getNarrowestIntegerTypeName(minValue, maxValue, size);
+            const std::size_t originalSize = field.decl.getASTContext().getTypeSizeInChars(field.decl.getType()).getQuantity();
+
+            return (size < originalSize ? storageTypeName : std::string(""));
+        }
+
+        // fields that are never read in any translation unit get no stream and are not part of the proxy type: methods of the element type
+        // are part of the proxy type as well, so that the fields they refer to are kept
+        bool isDeadField(const clang::FieldDecl& fieldDecl) const
+        {
+            if (!deadFieldElimination || !FieldAccessAnalysis::hasProgramFieldAccesses()) return false;
+
+            const clang::CXXRecordDecl* const recordDecl = llvm::dyn_cast<clang::CXXRecordDecl>(fieldDecl.getParent());
+            if (!recordDecl) return false;
+
+            const std::string recordName = recordDecl->getNameAsString();
+            auto isLive = [&recordDecl, &recordName] (const clang::FieldDecl& field)
+                {
+                    return (FieldAccessAnalysis::isFieldRead(recordName, field.getNameAsString()) || FieldAccessAnalysis::isReferencedByMethods(*recordDecl, field.getNameAsString()));
+                };
+
+            if (isLive(fieldDecl)) return false;
+
+            // there must be at least one stream
+            return std::any_of(recordDecl->field_begin(), recordDecl->field_end(), [&isLive] (const clang::FieldDecl* const field) { return isLive(*field); });
+        }
+
+        // writes to fields without stream: 'element.field = value;' becomes 'static_cast<void>(value);', which keeps the side effects of 'value'
+        void removeDeadFieldWrites(std::set<clang::FileID>& outputFiles, clang::ASTContext& context)
+        {
+            if (!fieldAccessAnalysis.get()) return;
+
+            const clang::SourceManager& sourceManager = context.getSourceManager();
+            std::set<clang::SourceLocation> modifiedWrites;
+
+            for (const auto& fieldWrite : fieldAccessAnalysis->getFieldWrites())
+            {
+                if (!isDeadField(*fieldWrite.first)) continue;
+
+                const clang::Expr* value = nullptr;
+                if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast<clang::BinaryOperator>(fieldWrite.second))
+                {
+                    value = binaryOperator->getRHS();
+                }
+                else if (const clang::CXXOperatorCallExpr* const operatorCallExpr = llvm::dyn_cast<clang::CXXOperatorCallExpr>(fieldWrite.second))
+                {
+                    value = operatorCallExpr->getArg(1);
+                }
+
+                // template instantiations share the write
+                const clang::SourceLocation beginLoc = fieldWrite.second->getBeginLoc();
+                if (!value || beginLoc.isMacroID() || value->getEndLoc().isMacroID() || !modifiedWrites.insert(beginLoc).second) continue;
+
+                const clang::FileID fileId = sourceManager.getFileID(beginLoc);
+                const std::size_t offset = sourceManager.getFileOffset(beginLoc);
+                const clang::SourceLocation valueEnd = clang::Lexer::getLocForEndOfToken(value->getEndLoc(), 0, sourceManager, context.getLangOpts());
+                clang::RewriteBuffer& rewriteBuffer = rewriter.getEditBuffer(fileId);
+
+                rewriteBuffer.ReplaceText(offset, sourceManager.getFileOffset(value->getBeginLoc()) - offset, std::string("static_cast<void>("));
+                rewriteBuffer.InsertTextAfter(sourceManager.getFileOffset(valueEnd), std::string(")"));
+                outputFiles.insert(fileId);
+            }
+        }
+
+        // bit streams are accessed through bit references (by value)
+        std::string getStreamReferenceTypeName(const std::string& streamTypeName) const
+        {
+            return (streamTypeName == bitStreamTypeName ? std::string("XXX_NAMESPACE::internal::bit_reference") : (streamTypeName + std::string("&")));
+        }
+
+        StreamLayout getStreamLayout(const ClassMetaData::Definition& definition) const
+        {
+            StreamLayout layout;
+            const std::uint32_t numFields = definition.fields.size();
+
+            layout.isLiveField.resize(numFields, true);
+            for (std::uint32_t i = 0; i < numFields; ++i)
+            {
+                layout.isLiveField[i] = !isDeadField(definition.fields[i].decl);
+            }
+
+            std::vector<std::string> fieldNames;
+            bool hasCompositeFields = false;
+            bool hasBitStreams = false;
+            for (std::uint32_t i = 0; i < numFields; ++i)
+            {
+                const auto& field = definition.fields[i];
+                const std::uint32_t firstStreamId = layout.streamTypeNames.size();
+                std::map<std::string, std::string> templateArguments;
+
+                if (layout.isLiveField[i])
+                {
+                    layout.liveFieldIds.push_back(i);
+                    fieldNames.push_back(field.name);
+
+                    if (field.isArray)
+                    {
+                        // one stream per array element
+                        for (std::size_t j = 0; j < field.arrayExtent; ++j)
+                        {
+                            layout.streamTypeNames.push_back(field.arrayElementTypeName);
+                        }
+                        hasCompositeFields = true;
+                    }
+                    else if (const ClassMetaData::Definition* const nestedDefinition = getNestedDefinition(field, &templateArguments))
+                    {
+                        // streams of the nested record: replace its template parameters by the template arguments of the field type
+                        for (std::string streamTypeName : getStreamLayout(*nestedDefinition).streamTypeNames)
+                        {
+                            for (const auto& templateArgument : templateArguments)
+                            {
+                                findAndReplace(streamTypeName, templateArgument.first, templateArgument.second, true, true);
+                            }
+                            layout.streamTypeNames.push_back(streamTypeName);
+                        }
+                        hasCompositeFields = true;
+                    }
+                    else if (isBitPackedField(field))
+                    {
+                        layout.streamTypeNames.push_back(bitStreamTypeName);
+                        hasBitStreams = true;
+                    }
+                    else if (getNarrowedStorageTypeName(field).length())
+                    {
+                        layout.streamTypeNames.push_back(getNarrowedStorageTypeName(field));
+                    }
+                    else
+                    {
+                        layout.streamTypeNames.push_back(field.elementTypeName);
+                    }
+                }
+
+                layout.fieldStreams.emplace_back(firstStreamId, layout.streamTypeNames.size() - firstStreamId);
+            }
+
+            for (const auto& streamTypeName : layout.streamTypeNames)
+            {
+                layout.isHomogeneous &= (streamTypeName == layout.streamTypeNames[0]);
+            }
+
+            // nested records with bool fields contribute bit streams as well
+            hasBitStreams |= (std::find(layout.streamTypeNames.begin(), layout.streamTypeNames.end(), bitStreamTypeName) != layout.streamTypeNames.end());
+
+            // bit streams are not addressed through offsets of a common base pointer, even if all streams are bit streams
+            layout.isHomogeneous &= !hasBitStreams;
+
+            // bit streams are not byte-addressable: they are neither packed nor clustered
+            layout.isPacked = (packedStreams && !layout.isHomogeneous && !hasBitStreams);
+
+            // clusters are AoS records of the same type: homogeneous types without array fields and nested records only
+            if (!fieldClustering || !FieldAccessAnalysis::hasProgramFieldAccesses() || !layout.isHomogeneous || hasCompositeFields || hasBitStreams) return layout;
+
+            for (const auto& cluster : FieldAccessAnalysis::getFieldClusters(definition.name, fieldNames))
+            {
+                layout.fieldClusters.emplace_back();
+                for (const auto& fieldName : cluster)
+                {
+                    layout.fieldClusters.back().push_back(layout.liveFieldIds[std::distance(fieldNames.begin(), std::find(fieldNames.begin(), fieldNames.end(), fieldName))]);
+                }
+            }
+
+            // pure SoA: nothing to do
+            if (layout.fieldClusters.size() == layout.liveFieldIds.size())
+            {
+                layout.fieldClusters.clear();
+            }
+
+            return layout;
+        }
+
+        static std::string generateStreamAccess(const StreamLayout& layout, const std::uint32_t streamId)
+        {
+            std::stringstream streamAccess;
+
+            if (layout.isHomogeneous)
+            {
+                streamAccess << "base.ptr[" << streamId << " * base.n_0]";
+            }
+            else if (layout.isPacked)
+            {
+                // the stream offsets within the allocation are compile-time constants (times base.n_0)
+                streamAccess << "base.template get<" << streamId << ">()";
+            }
+            else
+            {
+                streamAccess << "*(std::get<" << streamId << ">(base.ptr))";
+            }
+
+            return streamAccess.str();
+        }
+
+        // the proxy refers to element 'i' of each stream, which in general is not aligned: the hints apply to the stream base pointers (element 0),
+        // which the accessor and iterator pass through 'assume_aligned' before they are offset
+        std::string generateProxyClassAlignmentHint(const ClassMetaData::Definition& definition, const StreamLayout& layout) const
+        {
+            std::stringstream hint;
+            const Indentation Indent = definition.declaration.indent + 1;
+            const std::string indent(Indent.value, ' ');
+            const Indentation ExtIndent = definition.declaration.indent + 2;
+            const std::string extIndent(ExtIndent.value, ' ');
+
+            hint << "\n" << indent << "static base_pointer assume_aligned(base_pointer base)\n";
+            hint << indent << "{\n";
+            if (layout.fieldClusters.size() > 0)
+            {
+                hint << extIndent << "for (std::size_t c = 0; c < " << layout.fieldClusters.size() << "; ++c) ";
+                hint << "base.ptr[c] = static_cast<typename std::remove_reference<decltype(base.ptr[c])>::type>(__builtin_assume_aligned(base.ptr[c], alignment));\n";
+            }
+            else if (layout.isHomogeneous)
+            {
+                // the streams follow each other in one allocation, padded to a multiple of 'alignment'
+                hint << extIndent << "base.ptr = static_cast<decltype(base.ptr)>(__builtin_assume_aligned(base.ptr, alignment));\n";
+            }
+            else if (!layout.isPacked)
+            {
+                for (std::uint32_t i = 0; i < layout.streamTypeNames.size(); ++i)
+                {
+                    // bit streams are not element pointers
+                    if (layout.streamTypeNames[i] == bitStreamTypeName) continue;
+
+                    hint << extIndent << "std::get<" << i << ">(base.ptr) = static_cast<typename std::remove_reference<decltype(std::get<" << i << ">(base.ptr))>::type>";
+                    hint << "(__builtin_assume_aligned(std::get<" << i << ">(base.ptr), alignment));\n";
+                }
+            }
+            // packed streams: the offsets of the streams within the allocation are not multiples of 'alignment'
+            hint << extIndent << "return base;\n";
+            hint << indent << "}\n";
+
+            return hint.str();
+        }
+
+        std::string generateProxyClassConstructor(const ClassMetaData::Definition& definition, const StreamLayout& layout)
+        {
+            std::stringstream constructor;
+            const Indentation Indent = definition.declaration.indent + 1;
+            const std::string indent(Indent.value, ' ');
+            const Indentation ExtIndent = definition.declaration.indent + 2;
+            const std::string extIndent(ExtIndent.value, ' ');
+            const auto& fieldClusters = layout.fieldClusters;
+
+            constructor << definition.name << "_proxy(base_pointer base)\n" << extIndent << ":\n";
+
+            // fields without stream are not part of the proxy type
+            for (std::size_t i = 0; i < layout.liveFieldIds.size(); ++i)
+            {
+                const std::uint32_t fieldId = layout.liveFieldIds[i];
+                const auto& field = definition.fields[fieldId];
+                const std::uint32_t streamId = layout.getStreamId(fieldId);
+
+                if (fieldClusters.size() > 0)
+                {
+                    // base.ptr[c] points to the AoS record of cluster 'c'
+                    for (std::uint32_t clusterId = 0; clusterId < fieldClusters.size(); ++clusterId)
+                    {
+                        const auto& cluster = fieldClusters[clusterId];
+                        const auto it = std::find(cluster.begin(), cluster.end(), fieldId);
+
+                        if (it != cluster.end())
+                        {
+                            constructor << extIndent << field.name << "(base.ptr[" << clusterId << "][" << std::distance(cluster.begin(), it) << "])";
+                            break;
+                        }
+                    }
+                }
+                else if (field.isArray || field.isNestedRecord)
+                {
+                    // array proxies and nested proxies are constructed from references to their streams
+                    constructor << extIndent << field.name << "(std::forward_as_tuple(";
+                    for (std::uint32_t i = 0; i < layout.fieldStreams[fieldId].second; ++i)
+                    {
+                        constructor << (i == 0 ? "" : ", ") << generateStreamAccess(layout, streamId + i);
+                    }
+                    constructor << "))";
+                }
+                else
+                {
+                    constructor << extIndent << field.name << "(" << generateStreamAccess(layout, streamId) << ")";
+                }
+                constructor << ((i + 1) < layout.liveFieldIds.size() ? ",\n" : "\n");
+            }
+            constructor << indent << "{}\n";
+            
+            return constructor.str();
+        }
+
+        std::string generateProxyClassTupleConstructor(const ClassMetaData::Definition& definition, const StreamLayout& layout)
+        {
+            std::stringstream constructor;
+            const Indentation Indent = definition.declaration.indent + 1;
+            const std::string indent(Indent.value, ' ');
+            const Indentation ExtIndent = definition.declaration.indent + 2;
+            const std::string extIndent(ExtIndent.value, ' ');
+
+            // one tuple element per stream
+            constructor << definition.name << "_proxy(" << "std::tuple<";
+            for (std::uint32_t i = 0; i < layout.streamTypeNames.size(); ++i)
+            {
+                constructor << (i == 0 ? "" : ", ") << getStreamReferenceTypeName(layout.streamTypeNames[i]);
+            }
+            constructor << "> obj)\n" << extIndent << ":\n";
+
+            for (std::size_t i = 0; i < layout.liveFieldIds.size(); ++i)
+            {
+                const std::uint32_t fieldId = layout.liveFieldIds[i];
+                const auto& field = definition.fields[fieldId];
+                const std::uint32_t streamId = layout.getStreamId(fieldId);
+
+                if (field.isArray || field.isNestedRecord)
+                {
+                    constructor << extIndent << field.name << "(std::forward_as_tuple(";
+                    for (std::uint32_t i = 0; i < layout.fieldStreams[fieldId].second; ++i)
+                    {
+                        constructor << (i == 0 ? "" : ", ") << "std::get<" << (streamId + i) << ">(obj)";
+                    }
+                    constructor << "))";
+                }
+                else
+                {
+                    constructor << extIndent << field.name << "(std::get<" << streamId << ">(obj))";
+                }
+                constructor << ((i + 1) < layout.liveFieldIds.size() ? ",\n" : "\n");
+            }
+            constructor << indent << "{}\n";
+
+            return constructor.str();
+        }
+
+        // proxies have reference semantics: assignment writes the values of the referenced fields, and swap exchanges them,
+        // as required by algorithms that move elements through iterators (e.g. std::sort)
+        std::string generateProxyClassAssignment(const ClassMetaData::Definition& definition)
+        {
+            std::stringstream assignment;
+            const Indentation Indent = definition.declaration.indent + 1;
+            const std::string indent(Indent.value, ' ');
+            const Indentation ExtIndent = definition.declaration.indent + 2;
+            const std::string extIndent(ExtIndent.value, ' ');
+            const std::string proxyName = definition.name + std::string("_proxy");
+
+            // user-defined assignment operators are adapted like any other method
+            const bool hasAssignmentOperator = std::any_of(definition.cxxMethods.begin(), definition.cxxMethods.end(),
+                [] (const ClassMetaData::Function& method) { return (method.name == std::string("operator=")); });
+
+            // const fields (and arrays of const elements) delete the implicit assignment of the original type: its proxies are not assignable or swappable either
+            const bool hasConstField = std::any_of(definition.fields.begin(), definition.fields.end(),
+                [] (const ClassMetaData::Field& field) { return (field.isConst || field.decl.getASTContext().getBaseElementType(field.decl.getType()).isConstQualified()); });
+
+            if (hasConstField) return std::string("");
+
+            if (!hasAssignmentOperator)
+            {
+                for (const std::string& rhsType : {proxyName, std::string("original_type")})
+                {
+                    assignment << "\n" << indent << proxyName << "& operator=(const " << rhsType << "& rhs)\n";
+                    assignment << indent << "{\n";
+                    for (const auto& field : definition.fields)
+                    {
+                        if (isDeadField(field.decl)) continue;
+
+                        if (field.isArray)
+                        {
+                            assignment << extIndent << "for (std::size_t i = 0; i < " << field.arrayExtent << "; ++i) " << field.name << "[i] = rhs." << field.name << "[i];\n";
+                        }
+                        else
+                        {
+                            assignment << extIndent << field.name << " = rhs." << field.name << ";\n";
+                        }
+                    }
+                    assignment << extIndent << "return *this;\n";
+                    assignment << indent << "}\n";
+                }
+            }
+
+            // proxies are returned by value: swap takes them by value as well ('swap(*it_1, *it_2)')
+            assignment << "\n" << indent << "friend void swap(" << proxyName << " a, " << proxyName << " b)\n";
+            assignment << indent << "{\n";
+            assignment << extIndent << "const original_type tmp(a);\n";
+            assignment << extIndent << "a = b;\n";
+            assignment << extIndent << "b = tmp;\n";
+            assignment << indent << "}\n";
+
+            return assignment.str();
+        }
+
+        void generateProxyClassDefinition(const std::unique_ptr<ClassMetaData>& candidate, Rewriter& rewriter, const std::string header = std::string(""))
+        {
+            if (!candidate.get()) return;
+
+            // some file related locations
+            const clang::SourceManager& sourceManager = candidate->sourceManager;
+            clang::ASTContext& context = candidate->context;
+            const clang::FileID fileId = candidate->getDeclaration().fileId;
+            const clang::SourceLocation fileStart = sourceManager.getLocForStartOfFile(fileId);
+            const clang::SourceLocation fileEnd = sourceManager.getLocForEndOfFile(fileId);
+
+            // insert iterator class forward declaration (top level namespace) and include lines
+            {
+                const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
+                const clang::SourceLocation insertLocation = (declaration.namespaces.size() > 0 ? declaration.namespaces[0].sourceRange.getBegin() : declaration.sourceRange.getBegin());
+                
+                rewriter.insert(insertLocation, std::string("#include <common/memory.hpp>\n"));
+                rewriter.insert(insertLocation, std::string("#include <common/data_layout.hpp>\n\n"));
+                
+                const Indentation Indent = Indentation(declaration.indent.increment, declaration.indent.increment);
+                const std::string indent(Indent.value, ' ');
+                const Indentation ExtIndent = Indent + 1;
+                const std::string extIndent(ExtIndent.value, ' ');
+
+                std::stringstream iteratorForwardDeclStream;
+                iteratorForwardDeclStream << "namespace XXX_NAMESPACE\n{\n";
+                iteratorForwardDeclStream << indent << "namespace internal \n";
+                iteratorForwardDeclStream << indent << "{\n";
+                iteratorForwardDeclStream << extIndent << "template <typename P, typename R>\n";
+                iteratorForwardDeclStream << extIndent << "class iterator;\n";
+                iteratorForwardDeclStream << indent << "}\n";
+                iteratorForwardDeclStream << "}\n\n";
+                rewriter.insert(insertLocation, iteratorForwardDeclStream.str());
+
+                std::stringstream accessorForwardDeclStream;
+                accessorForwardDeclStream << "namespace XXX_NAMESPACE\n{\n";
+                accessorForwardDeclStream << indent << "namespace internal \n";
+                accessorForwardDeclStream << indent << "{\n";
+                accessorForwardDeclStream << extIndent << "template <typename X, std::size_t N, std::size_t D, XXX_NAMESPACE::data_layout L>\n";
+                accessorForwardDeclStream << extIndent << "class accessor;\n";
+                accessorForwardDeclStream << indent << "}\n";
+                accessorForwardDeclStream << "}\n\n";
+                rewriter.insert(insertLocation, accessorForwardDeclStream.str());
+            }
+
+
+            // declarations for which proxy equivalents need to be generated
+            const std::uint32_t numRelevantSourceRanges = candidate->relevantSourceRanges.size(); // is at least 1
+            ClassMetaData::SourceRangeSet::const_iterator sourceRange = candidate->relevantSourceRanges.cbegin();
+
+            // replace header
+            const clang::SourceRange fileStartToFirstDeclBegin(fileStart, sourceRange->getBegin().getLocWithOffset(-1));
+            if (fileStartToFirstDeclBegin.isValid())
+            { 
+                rewriter.replace(fileStartToFirstDeclBegin, header);
+            }
+
+            // remove everything that is not relevant for the proxy generation
+            for (std::uint32_t i = 0; i < (numRelevantSourceRanges - 1); ++i)
+            {
+
+                const clang::SourceLocation start = sourceRange->getEnd().getLocWithOffset(1);
+                const clang::SourceLocation end = (++sourceRange)->getBegin().getLocWithOffset(-1);
+                const clang::SourceRange toBeRemoved(start, end);
+                if (toBeRemoved.isValid() && toBeRemoved.getBegin() != toBeRemoved.getEnd())
+                {
+                    rewriter.remove(toBeRemoved);
+                }
+            }
+
+            const clang::SourceRange toBeRemoved(sourceRange->getEnd().getLocWithOffset(1), fileEnd);
+            if (toBeRemoved.isValid() && toBeRemoved.getBegin() != toBeRemoved.getEnd())
+            {
+                rewriter.replace(toBeRemoved, std::string("\n"));
+            }
+
+            // declaration: replace class name by proxy class name
+            const std::string proxyNamespace = std::string("proxy_internal");
+
+            const ClassMetaData::Declaration& declaration = candidate->getDeclaration();
+            if (!declaration.isDefinition)
+            {
+                // insert proxy namespace
+                const Indentation Indent = declaration.indent;
+                const std::string indent(Indent.value, ' ');
+
+                rewriter.insert(declaration.extendedSourceRange.getBegin(), indent + std::string("namespace ") + proxyNamespace + std::string("\n") + indent + std::string("{\n"));
+                rewriter.insert(declaration.extendedSourceRange.getEnd(), indent + std::string("\n") + indent + std::string("}\n"));
+
+                rewriter.replace(declaration.nameSourceRange, declaration.name + std::string("_proxy"));
+            }
+
+            // target class namespace prefix
+            std::string targetClassNamespace;
+            for (const auto& thisNamespace : candidate->getDeclaration().namespaces)
+            {
+                targetClassNamespace += (thisNamespace.name + std::string("::"));
+            }
+
+            // definitions
+            const std::vector<ClassMetaData::Definition>& definitions = candidate->getDefinitions();
+            for (const auto& definition : definitions)
+            {
+                // insert proxy namespace
+                const Indentation Indent = definition.declaration.indent;
+                const std::string indent(Indent.value, ' ');
+
+                rewriter.insert(definition.extendedSourceRange.getBegin(), indent + std::string("namespace ") + proxyNamespace + std::string("\n") + indent + std::string("{\n"));
+                rewriter.insert(definition.extendedSourceRange.getEnd(), indent + std::string("\n") + indent + std::string("}\n"));
+
+                // replace class name by proxy class name
+                rewriter.replace(definition.nameSourceRange, definition.name + std::string("_proxy"));
+
+                // indentation
+                const Indentation ExtIndent = Indent + 1;
+                const std::string extIndent(ExtIndent.value, ' ');
+                const Indentation ExtExtIndent = ExtIndent + 1;
+                const std::string extExtIndent(ExtExtIndent.value, ' ');
+
+                // open private region
+                rewriter.insert(definition.innerLocBegin, std::string("\n") + indent + std::string("private:\n"));
+
+                // friend declarations
+                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("template <typename _X, std::size_t _N, std::size_t _D, XXX_NAMESPACE::data_layout _L>\n") + extIndent + std::string("friend class XXX_NAMESPACE::internal::accessor;\n"));
+                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("template <typename _P, typename _R>\n") + extIndent + std::string("friend class XXX_NAMESPACE::internal::iterator;\n"));
+
+                // insert meta data: unqualified type
+                for (const auto& templateParamter : definition.declaration.templateParameters)
+                {
+                    if (!templateParamter.isTypeParameter) continue;
+
+                    const std::string parameterName = templateParamter.name;
+
+                    rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("using ") + parameterName + std::string("_unqualified = typename std::remove_cv<") + parameterName + std::string(">::type;\n"));
+                }
+
+                // insert meta data: is const type?
+                if (definition.declaration.templateParameters.size() > 0)
+                {
+                    std::stringstream isConstTypeStream;
+                    isConstTypeStream << "\n" << extIndent << "static constexpr bool is_const_type = (";
+                    std::uint32_t templateParameterId = 0;
+                    for (const auto& templateParamter : definition.declaration.templateParameters)
+                    {
+                        if (!templateParamter.isTypeParameter) continue;
+
+                        const std::string parameterName = templateParamter.name;
+
+                        isConstTypeStream << (templateParameterId == 0 ? "" : " || " ) << "std::is_const<" << parameterName << ">::value";
+                        ++templateParameterId;
+                    }
+                    isConstTypeStream << ");\n";
+                    rewriter.insert(definition.innerLocBegin, isConstTypeStream.str());
+                }
+
+                // open public region
+                rewriter.insert(definition.innerLocBegin, std::string("\n") + indent + std::string("public:\n"));
+
+                const clang::SourceLocation publicAccess = definition.accessSpecifiers[definition.indexPublicAccessSpecifiers[0]].scopeBegin;
+
+                // insert meta data: type and const_type
+                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("using type = ") + definition.name + std::string("_proxy") + definition.templateParameterString + std::string(";\n"));
+                rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("using const_type = ") + definition.name + std::string("_proxy") + definition.templateConstParameterString + std::string(";\n"));
+
+                // insert meta data: base pointer type?
+                std::stringstream basePointerStream;
+                const StreamLayout layout = getStreamLayout(definition);
+                basePointerStream << "\n" << extIndent << "using base_pointer = XXX_NAMESPACE::multi_pointer_";
+                if (layout.fieldClusters.size() > 0)
+                {
+                    // one stream per cluster: the cluster sizes are the template arguments
+                    basePointerStream << "clustered<" << layout.streamTypeNames[0];
+                    for (const auto& cluster : layout.fieldClusters)
+                    {
+                        basePointerStream << ", " << cluster.size();
+                    }
+                }
+                else if (layout.isHomogeneous)
+                {
+                    basePointerStream << "n<" << layout.streamTypeNames[0] << ", " << std::to_string(layout.streamTypeNames.size());
+                }
+                else
+                {
+                    // packed: one allocation, streams ordered as the fields, stream k at n_0 * (sizeof(T_0) + ... + sizeof(T_k-1)) with n_0 padded such that each stream is aligned for its type
+                    basePointerStream << (layout.isPacked ? "packed<" : "inhomogeneous<");
+
+                    for (std::uint32_t i = 0; i < layout.streamTypeNames.size(); ++i)
+                    {
+                        basePointerStream << (i == 0 ? "" : ", ") << layout.streamTypeNames[i];
+                    }
+                }
+                basePointerStream << ">;\n";
+                rewriter.insert(definition.innerLocBegin, basePointerStream.str());
+
+                // insert meta data: stream alignment and the hint that marks the stream base pointers as aligned
+                if (streamAlignment > 0)
+                {
+                    rewriter.insert(definition.innerLocBegin, std::string("\n") + extIndent + std::string("static constexpr std::size_t alignment = ") + std::to_string(streamAlignment) + std::string(";\n"));
+                    rewriter.insert(definition.innerLocBegin, generateProxyClassAlignmentHint(definition, layout));
+                }
+
+                // insert meta data: original type
+                std::stringstream originalType;
+                {
+                    originalType << targetClassNamespace << definition.name;
+                    std::uint32_t templateParameterId = 0;
+                    for (const auto& templateParamter : definition.declaration.templateParameters)
+                    {
+                        const std::string parameterName = (definition.isTemplatePartialSpecialization ? definition.templatePartialSpecializationArguments[templateParameterId].first : templateParamter.name) +
+                            std::string(templateParamter.isTypeParameter ? "_unqualified" : "");
+
+                        originalType << (templateParameterId == 0 ? "<" : ", ") << parameterName;
+                        ++templateParameterId;
+                        if (templateParameterId == definition.declaration.templateParameters.size())
+                        {
+                            originalType << ">";        
+                        }
+                    }
+                }
+
+                std::stringstream originalTypeStream;
+                if (definition.declaration.templateParameters.size() > 0)
+                {
+                    originalTypeStream << "\n" << extIndent << "using original_type = typename std::conditional<is_const_type,\n";
+                    originalTypeStream << extExtIndent << "const " << originalType.str() << ",\n";
+                    originalTypeStream << extExtIndent << originalType.str();
+                    originalTypeStream << ">::type;\n";
+
+                }
+                else
+                {
+                    originalTypeStream << "\n" << extIndent << "using original_type = " << definition.name << ";\n";
+                }
+                
+                rewriter.insert(definition.innerLocBegin, originalTypeStream.str());
+
+                // open private region for classes
+                if (definition.declaration.isClass)
+                {
+                    rewriter.insert(definition.innerLocBegin, std::string("\n") + indent + std::string("private:\n"));
+                }
+
+                // constructors
+                std::vector<std::string> proxyClassConstructors;
+                proxyClassConstructors.emplace_back(generateProxyClassConstructor(definition, layout));
+                proxyClassConstructors.emplace_back(generateProxyClassTupleConstructor(definition, layout));
+
+                const std::uint32_t numConstructorsToBeInserted = proxyClassConstructors.size();
+                const std::uint32_t numConstructorLocationsAvailable = definition.indexPublicConstructors.size();
+                const std::uint32_t numConstructorsInserted = std::min(numConstructorLocationsAvailable, numConstructorsToBeInserted);
+                for (std::uint32_t i = 0; i < numConstructorsInserted; ++i)
+                {
+                    rewriter.replace(definition.constructors[definition.indexPublicConstructors[i]].sourceRange, proxyClassConstructors[i]);
+                }
+                const clang::SourceLocation fallbackSourceLocation = (definition.indexPublicAccessSpecifiers.size() > 0 ? definition.accessSpecifiers[definition.indexPublicAccessSpecifiers[0]].scopeBegin : definition.innerLocBegin);
+                for (std::uint32_t i = numConstructorsInserted; i < proxyClassConstructors.size(); ++i)
+                {
+                    rewriter.insert(fallbackSourceLocation, std::string("\n") + proxyClassConstructors[i]);
+                }
+
+                for (std::uint32_t i = numConstructorsInserted; i < definition.constructors.size(); ++i)
+                {
+                    rewriter.remove(definition.constructors[i].sourceRange);
+                }
+
+                rewriter.insert(fallbackSourceLocation, generateProxyClassAssignment(definition));
+
+                // adapt functions
+                for (const auto& method : definition.cxxMethods)
+                {
+                    if (!method.hasClassTypeArguments && !method.returnsClassType) continue;
+
+                    // only return value is of class type
+                    if (method.returnsClassType && !method.hasClassTypeArguments)
+                    {
+                        if (method.returnsClassTypeReference)
+                        {
+                            rewriter.replace(getSpellingSourceRange(method.returnTypeSourceRange, context), definition.name + std::string("_proxy"));
+                        }
+                        else
+                        {
+                            // TODO: fix that -> for some reason the closing bracket of the body is not included -> add "1"
+                            const clang::SourceRange selectionSourceRange(method.macroDefinitionSourceRange.getBegin(), method.macroDefinitionSourceRange.getEnd().getLocWithOffset(1));
+                            std::string selection = dumpSourceRangeToString(selectionSourceRange, sourceManager);
+                            findAndReplace(selection, definition.name, originalType.str(), true, true);
+                            rewriter.replace(selectionSourceRange, selection);
+                        }
+                    }
+
+                    // return value and arguments can be of class type
+                    if (method.hasClassTypeArguments)
+                    {
+                        modifyMethodSignature(definition, method, rewriter, std::string(""), targetClassNamespace, true);
+                    }
+                }
+
+                // change field types -> reference values (fields without stream are removed, arrays and nested records become array proxies and nested proxies)
+                std::uint32_t fieldId = 0;
+                for (const auto& field : definition.fields)
+                {
+                    if (!layout.isLiveField[fieldId])
+                    {
+                        rewriter.remove(getSourceRangeWithClosingCharacter(field.sourceRange, std::string(";"), context, false));
+                    }
+                    else if (field.isArray)
+                    {
+                        // array_proxy<T, N>::operator[] refers to stream 'k' directly: compile-time 'k' resolves to a fixed stream
+                        rewriter.replace(field.sourceRange, std::string("XXX_NAMESPACE::internal::array_proxy<") + field.arrayElementTypeName + std::string(", ") + std::to_string(field.arrayExtent) + std::string("> ") + field.name);
+                    }
+                    else if (field.isNestedRecord)
+                    {
+                        // the type as written may be const qualified or shared with other declarators: use the unqualified type
+                        const std::string recordTypeName = field.decl.getType().getUnqualifiedType().getAsString(context.getPrintingPolicy());
+                        rewriter.replace(field.sourceRange, std::string(field.isConst ? "const " : "") + std::string("typename ") + recordTypeName + std::string("::proxy_type ") + field.name);
+                    }
+                    else if (isBitPackedField(field))
+                    {
+                        rewriter.replace(field.sourceRange, getStreamReferenceTypeName(bitStreamTypeName) + std::string(" ") + field.name);
+                    }
+                    else if (getNarrowedStorageTypeName(field).length())
+                    {
+                        // widens on read, narrows on write: values outside an annotated range are truncated (the range is not checked)
+                        rewriter.replace(field.sourceRange, std::string("XXX_NAMESPACE::internal::narrowed_reference<") + field.typeName + std::string(", ") + getNarrowedStorageTypeName(field) + std::string("> ") + field.name);
+                    }
+                    else
+                    {
+                        rewriter.replace(field.sourceRange, field.typeName + std::string("& ") + field.name);
+                    }
+                    ++fieldId;
+                }
+            }
+        }
+
+        std::vector<const clang::FunctionDecl*> findFunctionsWithTargetParameters(const ClassMetaData& target)
+        {
+            using namespace clang::ast_matchers;
+
+            Matcher matcher;
+            clang::ASTContext& context = target.context;
+            std::vector<const clang::FunctionDecl*> functions;
+            
+            matcher.addMatcher(functionDecl().bind("functionDeclaration"),
+                    [this, &target, &context, &functions] (const MatchFinder::MatchResult& result) mutable
+                    {
+                        if (const clang::FunctionDecl* const decl = result.Nodes.getNodeAs<clang::FunctionDecl>("functionDeclaration"))
+                        {
+                            const std::string sourceLocationString = decl->getBeginLoc().printToString(context.getSourceManager());
+                            
+                            if (sourceLocationString.find("usr/lib") != std::string::npos ||
+                                sourceLocationString.find("usr/include") != std::string::npos) return;
+
+                            if (decl->getNumParams() == 0) return;
+
+                            bool hasTargetArgument = false;
+                            for (const auto& parameter : decl->parameters())
+                            {
+                                if (parameter->getType().getAsString().find(target.getDeclaration().name) != std::string::npos)
+                                {
+                                    hasTargetArgument = true;
+                                    break;
+                                }
+                            }
+
+                            if (!hasTargetArgument) return;
+
+                            // skip all functions that are within the definition of any of the classes considered
+                            for (const auto& definition : target.getDefinitions())
+                            {
+                                const std::size_t defBeginLine = getSpellingLineNumber(definition.sourceRange.getBegin(), context);
+                                const std::size_t defEndLine = getSpellingLineNumber(definition.sourceRange.getEnd(), context);
+                                const std::size_t declBeginLine = getSpellingLineNumber(decl->getSourceRange().getBegin(), context);
+
+                                if (defBeginLine < declBeginLine && declBeginLine < defEndLine) return;
+                            }
+
+                            for (const auto& definitionSourceRange : target.getDefinitionsSortedOut())
+                            {
+                                const std::size_t defBeginLine = getSpellingLineNumber(definitionSourceRange.getBegin(), context);
+                                const std::size_t defEndLine = getSpellingLineNumber(definitionSourceRange.getEnd(), context);
+                                const std::size_t declBeginLine = getSpellingLineNumber(decl->getSourceRange().getBegin(), context);
+
+                                if (defBeginLine < declBeginLine && declBeginLine < defEndLine) return;
+                            }
+
+                            const auto& it = std::lower_bound(functions.begin(), functions.end(), decl, [&context] (const clang::FunctionDecl* d_1, const clang::FunctionDecl* d_2)
+                                {
+                                    const std::size_t beginLoc_d_1 = getSpellingLineNumber(d_1->getSourceRange().getBegin(), context);
+                                    const std::size_t beginLoc_d_2 = getSpellingLineNumber(d_2->getSourceRange().getBegin(), context);
+                                    return (beginLoc_d_1 < beginLoc_d_2);
+                                });
+
+
+                            if (it == functions.end() || (*it)->getSourceRange() != decl->getSourceRange())
+                            {
+                                functions.insert(it, decl);
+                            }
+                        }
+                    });
+
+            matcher.run(target.context);
+
+            return functions;
+        }
+        
+        void addProxyClassToSource(const std::vector<std::unique_ptr<ClassMetaData>>& proxyClassTargets, clang::ASTContext& context)
+        {
+            // make a hard copy before applying any changes to the source code
+            Rewriter proxyClassCreator(rewriter);
+        
+            for (const auto& target : proxyClassTargets)
+            {
+                if (!target->containsProxyClassCandidates) continue;
+
+                // check if the source file containing the original code, also contains function definitions with class type paramters: add them if needed
+                std::vector<const clang::FunctionDecl*> functionsWithTargetParameters = findFunctionsWithTargetParameters(*target);
+
+                for (const auto& function : functionsWithTargetParameters)
+                {
+                    const clang::FileID fileId = context.getSourceManager().getFileID(function->getLocation());
+                    if (fileId == target->fileId)
+                    {
+                        const clang::FunctionTemplateDecl* templateFunctionDecl = function->getDescribedFunctionTemplate();
+                        const clang::SourceRange functionSourceRange = (templateFunctionDecl == nullptr ? function->getSourceRange() : templateFunctionDecl->getSourceRange());
+                        target->getRelevantSourceRanges().insert(clang::SourceRange(getBeginOfLine(functionSourceRange.getBegin(), context), functionSourceRange.getEnd()));
+                    }
+                }
+                target->updateRelevantSourceRangeInfo();
+
+                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+                // modify original source code
+                modifyOriginalSourceCode(target, rewriter);
+
+                {
+                    std::string outputString;
+                    llvm::raw_string_ostream outputStream(outputString);
+                    rewriter.getEditBuffer(target->fileId).write(outputStream);
+            
+                    std::string outputFilename(target->filename);
+                    const std::size_t pos = outputFilename.rfind('/');
+
+                    if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
+                    {
+                        const std::string filename = outputFilename.substr(pos);
+                        outputFilename = std::string(output_path) + filename;
+                    }
+                    else
+                    {
+                        outputFilename.insert(pos != std::string::npos ? (pos + 1) : 0, "new_files/");
+                    }
+
+                    std::ofstream out(outputFilename);
+                    if (out)
+                    {
+                        out << outputStream.str();
+                        out.close();
+                    }
+                    else
+                    {
+                        std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
+                    }    
+                }
+
+                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+                // generate proxy class definition
+                generateProxyClassDefinition(target, proxyClassCreator, std::string("// my header\n"));
+
+                // process functions that are not within the class
+                for (auto it = functionsWithTargetParameters.begin(); it != functionsWithTargetParameters.end(); )
+                {
+                    const auto& function = *it;
+                    const clang::FileID fileId = context.getSourceManager().getFileID(function->getLocation());
+                    if (fileId == target->fileId)
+                    {
+                        const clang::FunctionTemplateDecl* templateFunctionDecl = function->getDescribedFunctionTemplate();
                         const clang::SourceRange functionSourceRange = (templateFunctionDecl == nullptr ? function->getSourceRange() : templateFunctionDecl->getSourceRange());
                         const std::string indent(getSpellingColumnNumber(functionSourceRange.getBegin(), context) - 1, ' ');
                         std::string functionDefinition = dumpSourceRangeToString({functionSourceRange.getBegin(), functionSourceRange.getEnd().getLocWithOffset(1)}, context.getSourceManager());
 
-                        findAndReplace(functionDefinition, target->name, target->name + std::string("_proxy"), true, true);
-                        proxyClassCreator.replace(functionSourceRange, functionDefinition);
+                        findAndReplace(functionDefinition, target->name, target->name + std::string("_proxy"), true, true);
+                        proxyClassCreator.replace(functionSourceRange, functionDefinition);
+
+                        const bool isInputOutputOperator = (function->getNameAsString() == std::string("operator<<") || function->getNameAsString() == std::string("operator>>"));
+                        if (isInputOutputOperator)
+                        {
+                            proxyClassCreator.insert(functionSourceRange.getBegin(), std::string("namespace ") + proxyNamespace + std::string("\n") + indent + std::string("{\n") + indent);
+                            proxyClassCreator.insert(functionSourceRange.getEnd().getLocWithOffset(1), std::string("\n") + indent + std::string("}"));
+                        }
+
+                       it = functionsWithTargetParameters.erase(it);
+                       continue;
+                    }
+
+                    ++it;
+                }
+
+
+                if (functionsWithTargetParameters.size() > 0)
+                {
+                    proxyClassCreator.insert(target->bottomMostSourceLocation.getLocWithOffset(1), std::string("\n\n#include \"") + std::string("autogen_") + target->name + std::string("_proxy_func.hpp\""));
+                }
+
+                {
+                    std::string outputString;
+                    llvm::raw_string_ostream outputStream(outputString);
+                    
+                    proxyClassCreator.getEditBuffer(target->fileId).write(outputStream);
+
+                    std::string outputFilename(target->filename);
+
+                    if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
+                    {
+                        outputFilename = std::string(output_path);
+                    }
+                    else
+                    {
+                        const std::size_t pos = outputFilename.rfind('/');
+                        outputFilename = outputFilename.substr(0, pos) + std::string("/new_files");
+                    }
+                    outputFilename += (std::string("/autogen_") + target->name + std::string("_proxy.hpp"));
+                    
+                    std::ofstream out(outputFilename);
+                    if (out)
+                    {
+                        out << outputStream.str();
+                        out.close();
+                    }
+                    else
+                    {
+                        std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
+                    } 
+                }
+
+                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+                // transform all remaining functions with target class parameters
+                std::stringstream globalFunctionString;
+                for (const auto& function : functionsWithTargetParameters)
+                {
+                    // deduce namespaces
+                    std::string fn;
+                    llvm::raw_string_ostream fullNameRawString(fn);
+                    function->getNameForDiagnostic(fullNameRawString, clang::PrintingPolicy(clang::LangOptions()), true);
+                    std::string fullName = fullNameRawString.str();
+                    std::vector<std::string> namespaces;
+                    std::size_t pos = fullName.find("::");
+
+                    while (pos != std::string::npos)
+                    {
+                        namespaces.push_back(fullName.substr(0, pos));
+                        fullName = fullName.substr(pos + 2);
+                        pos = fullName.find("::");
+                    }
+
+                    // modify function signature
+                    const clang::FunctionTemplateDecl* templateFunctionDecl = function->getDescribedFunctionTemplate();
+                    const clang::SourceRange functionSourceRange = (templateFunctionDecl == nullptr ? function->getSourceRange() : templateFunctionDecl->getSourceRange());
+                    const std::string indent(getSpellingColumnNumber(functionSourceRange.getBegin(), context) - 1, ' ');
+                    const clang::SourceLocation parameterListBeginLoc = function->getParamDecl(0)->getSourceRange().getBegin();
+                    const clang::SourceLocation parameterListEndLoc = (function->hasBody() ? function->getBody()->getSourceRange().getBegin() : functionSourceRange.getEnd());
+                    std::string selection_1 = dumpSourceRangeToString({functionSourceRange.getBegin(), parameterListBeginLoc}, context.getSourceManager());
+                    std::string selection_2 = dumpSourceRangeToString({parameterListBeginLoc, parameterListEndLoc}, context.getSourceManager());
+                    std::string selection_3 = dumpSourceRangeToString({parameterListEndLoc, functionSourceRange.getEnd().getLocWithOffset(1)}, context.getSourceManager());
+
+                    std::string proxyTypeNamespacePrefix;
+                    for (const auto& ns : target->getDeclaration().namespaces)
+                    {
+                        proxyTypeNamespacePrefix += ns.name;
+                    }
+                    proxyTypeNamespacePrefix += std::string("::");
+                    std::string proxyTypeName = proxyTypeNamespacePrefix + proxyNamespace + std::string("::") + target->name + std::string("_proxy");
+
+                    if (function->getDeclaredReturnType()->isReferenceType())
+                    {
+                        findAndReplace(selection_1, proxyTypeNamespacePrefix + target->name, proxyTypeName, true, true);
+                        findAndReplace(selection_1, target->name, proxyTypeName, true, true);
+                    }
+                    findAndReplace(selection_2, proxyTypeNamespacePrefix + target->name, proxyTypeName, true, true);
+                    findAndReplace(selection_2, target->name, proxyTypeName, true, true);
+                    const std::size_t numNamespaces = namespaces.size();
+
+                    std::string extIndent;
+                    for (std::size_t i = 0; i < numNamespaces; ++i)
+                    {
+                        globalFunctionString << extIndent << "namespace " << namespaces[i] << "\n";
+                        globalFunctionString << extIndent << "{\n";
 
-                        const bool isInputOutputOperator = (function->getNameAsString() == std::string("operator<<") || function->getNameAsString() == std::string("operator>>"));
-                        if (isInputOutputOperator)
+                        extIndent += indent;
+                    }
+
+                    globalFunctionString << extIndent << selection_1;
+                    globalFunctionString << selection_2;
+                    globalFunctionString << selection_3 << std::endl;
+
+                    if (numNamespaces > 0)
+                    {
+                        for (std::size_t i = (numNamespaces - 1); i >= 0; --i)
                         {
-                            proxyClassCreator.insert(functionSourceRange.getBegin(), std::string("namespace ") + proxyNamespace + std::string("\n") + indent + std::string("{\n") + indent);
-                            proxyClassCreator.insert(functionSourceRange.getEnd().getLocWithOffset(1), std::string("\n") + indent + std::string("}"));
+                            extIndent = std::string("");
+                            for (std::size_t j = 0; j < i; ++j)
+                            {
+                                extIndent += indent;
+                            }
+                            globalFunctionString << extIndent << "}\n\n";
+
+                            if (i == 0) break;  
+                        }
+                    }
+                }
+
+                // write to file
+                if (functionsWithTargetParameters.size() > 0)
+                {
+                    std::string outputFilename(target->filename);
+
+                    if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
+                    {
+                        outputFilename = std::string(output_path);
+                    }
+                    else
+                    {
+                        const std::size_t pos = outputFilename.rfind('/');
+                        outputFilename = outputFilename.substr(0, pos) + std::string("/new_files");
+                    }
+                    outputFilename += (std::string("/autogen_") + target->name + std::string("_proxy_func.hpp"));
+
+                    std::ofstream out(outputFilename);
+                    if (out)
+                    {
+                        out << globalFunctionString.str();
+                        out.close();
+                    }
+                    else
+                    {
+                        std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
+                    }
+                }
+            }
+        }
+
+        void modifyIncludeStatements(const std::vector<std::unique_ptr<ClassMetaData>>& proxyClassTargets, clang::ASTContext& context)
+        {
+            for (const auto& target : proxyClassTargets)
+            {
+                const clang::SourceLocation includeLocation = target->sourceManager.getIncludeLoc(target->fileId);
+                const clang::SourceLocation includeLineBegin = getBeginOfLine(includeLocation, target->context);
+                const clang::SourceLocation includeLineEnd = getNextLine(includeLocation, target->context).getLocWithOffset(-1);
+                const std::size_t includeLineLength = getSpellingColumnNumber(includeLineEnd, target->context) - getSpellingColumnNumber(includeLineBegin, target->context);
+
+                clang::RewriteBuffer& rewriteBuffer = rewriter.getEditBuffer(target->sourceManager.getFileID(includeLocation));
+                rewriteBuffer.ReplaceText(target->sourceManager.getFileOffset(includeLineBegin), includeLineLength, std::string("#include \"") + target->name + std::string(".hpp\""));
+                rewriteBuffer.InsertTextBefore(target->sourceManager.getFileOffset(includeLineBegin), std::string("#include <buffer/buffer.hpp>\n"));
+            }
+        }
+
+        std::vector<std::string> getBufferPolicies(const Declaration& declaration) const
+        {
+            std::vector<std::string> policies;
+
+            // all field streams start on an 'alignment'-byte boundary and are padded to a multiple of it
+            if (streamAlignment > 0)
+            {
+                policies.push_back(std::string("XXX_NAMESPACE::aligned<") + std::to_string(streamAlignment) + std::string(">"));
+            }
+
+            // rows of jagged buffers are one-dimensional and can grow: no other policies apply
+            if (isJaggedDeclaration(declaration)) return policies;
+
+            // the buffer allocates extent + 2 * width elements per dimension: indices [-width, extent + width) are valid
+            const std::vector<std::size_t>& haloWidth = getHaloWidth(declaration);
+            if (haloWidth.size() > 0)
+            {
+                std::stringstream policy;
+                policy << "XXX_NAMESPACE::halo<";
+                for (std::size_t i = 0; i < haloWidth.size(); ++i)
+                {
+                    policy << (i == 0 ? "" : ", ") << haloWidth[i];
+                }
+                policy << ">";
+                policies.push_back(policy.str());
+            }
+
+            // deques: chunked streams, so that growth never moves elements
+            const clang::CXXRecordDecl* const containerDecl = declaration.decl.getType()->getAsCXXRecordDecl();
+            const ContainerDescriptor* const descriptor = (containerDecl ? ContainerDescriptor::find(containerDescriptors, containerDecl->getNameAsString()) : nullptr);
+            if (descriptor && descriptor->isChunked && declaration.isContainerDeclaration())
+            {
+                policies.push_back(std::string("XXX_NAMESPACE::chunked"));
+            }
+
+            // push_back, emplace_back (rewritten to push_back), resize and reserve keep the semantics of std::vector
+            if (growableDeclarations.find(&declaration.decl) != growableDeclarations.end())
+            {
+                policies.push_back(std::string("XXX_NAMESPACE::growable"));
+            }
+
+            // appends from multiple threads: atomic index reservation and chunked growth that never moves elements
+            if (concurrentAppendDeclarations.find(&declaration.decl) != concurrentAppendDeclarations.end())
+            {
+                policies.push_back(std::string("XXX_NAMESPACE::concurrent_append"));
+            }
+
+            // storage order of the elements within each stream: the indexing interface does not change
+            if (getIndexOrder(declaration) == std::string("morton"))
+            {
+                policies.push_back(std::string("XXX_NAMESPACE::morton_order"));
+            }
+            else if (getIndexOrder(declaration) == std::string("tiled"))
+            {
+                // each tile holds all field streams of its elements contiguously
+                std::stringstream policy;
+                policy << "XXX_NAMESPACE::tiled<";
+                const std::vector<std::size_t>& extent = getTileExtent(declaration);
+                for (std::size_t i = 0; i < extent.size(); ++i)
+                {
+                    policy << (i == 0 ? "" : ", ") << extent[i];
+                }
+                policy << ">";
+                policies.push_back(policy.str());
+            }
+
+            return policies;
+        }
+
+        // element ranges of the buffer can be described by base pointers, extents and strides (strided views)
+        bool isStridedDeclaration(const Declaration& declaration) const
+        {
+            if (isJaggedDeclaration(declaration) || getIndexOrder(declaration) != std::string("row_major")) return false;
+
+            // chunked storage is not contiguous within a stream
+            const std::vector<std::string> policies = getBufferPolicies(declaration);
+
+            return (std::find(policies.begin(), policies.end(), std::string("XXX_NAMESPACE::chunked")) == policies.end() &&
+                std::find(policies.begin(), policies.end(), std::string("XXX_NAMESPACE::concurrent_append")) == policies.end());
+        }
+
+        const IndexSpace& getIndexSpace(const Declaration& declaration) const
+        {
+            auto it = indexSpaces.find(&declaration);
+            if (it == indexSpaces.end())
+            {
+                IndexSpace indexSpace;
+                indexSpace.indexOrder = parseIndexOrder(declaration);
+                indexSpace.tileExtent = (indexSpace.indexOrder == std::string("tiled") ? parseTileExtent(declaration) : std::vector<std::size_t>());
+                if (indexSpace.indexOrder == std::string("tiled") && indexSpace.tileExtent.size() == 0)
+                {
+                    indexSpace.indexOrder = std::string("row_major");
+                }
+                indexSpace.haloWidth = parseHaloWidth(declaration, indexSpace.indexOrder);
+
+                it = indexSpaces.insert(std::make_pair(&declaration, indexSpace)).first;
+            }
+
+            return it->second;
+        }
+
+        std::string getIndexOrder(const Declaration& declaration) const
+        {
+            return getIndexSpace(declaration).indexOrder;
+        }
+
+        const std::vector<std::size_t>& getTileExtent(const Declaration& declaration) const
+        {
+            return getIndexSpace(declaration).tileExtent;
+        }
+
+        const std::vector<std::size_t>& getHaloWidth(const Declaration& declaration) const
+        {
+            return getIndexSpace(declaration).haloWidth;
+        }
+
+        // the annotation 'trafo:index_order=...' overrides the global setting
+        std::string parseIndexOrder(const Declaration& declaration) const
+        {
+            const auto annotation = declaration.annotations.find("index_order");
+            const bool isAnnotated = (annotation != declaration.annotations.end());
+            const std::string order = (isAnnotated ? annotation->second : indexOrder);
+            const std::size_t numDimensions = declaration.getNestingLevel() + 1;
+
+            if (order == std::string("morton"))
+            {
+                // Z-order curves interleave the bits of 2 or 3 indices
+                if (numDimensions == 2 || numDimensions == 3)
+                {
+                    // the curve covers the power-of-two bounding box of the extents
+                    if (declaration.hasConstantExtent())
+                    {
+                        std::size_t numElements = 1;
+                        std::size_t numStoredElements = 1;
+                        for (std::size_t i = 0; i < numDimensions; ++i)
+                        {
+                            std::size_t paddedExtent = 1;
+                            while (paddedExtent < declaration.getExtent().at(i)) paddedExtent *= 2;
+
+                            numElements *= declaration.getExtent().at(i);
+                            numStoredElements *= paddedExtent;
+                        }
+
+                        if (numStoredElements > 2 * numElements)
+                        {
+                            std::cerr << "warning: morton order stores " << numStoredElements << " instead of " << numElements << " elements: " << declaration.decl.getNameAsString() << std::endl;
                         }
+                    }
+
+                    return order;
+                }
+
+                if (isAnnotated)
+                {
+                    std::cerr << "warning: morton order requires a 2- or 3-dimensional declaration: " << declaration.decl.getNameAsString() << " -> ignored" << std::endl;
+                }
+            }
+            else if (order == std::string("tiled"))
+            {
+                // one-dimensional buffers are contiguous anyway (and keep their strided views): the tile extents are validated separately
+                if (numDimensions >= 2) return order;
+
+                if (isAnnotated)
+                {
+                    std::cerr << "warning: tiled order requires a multi-dimensional declaration: " << declaration.decl.getNameAsString() << " -> ignored" << std::endl;
+                }
+            }
+            else if (isAnnotated && order != std::string("row_major"))
+            {
+                std::cerr << "warning: index order " << order << " is not supported: " << declaration.decl.getNameAsString() << " -> ignored" << std::endl;
+            }
+
+            return std::string("row_major");
+        }
+
+        // tile extents from the outermost to the innermost dimension: a single value applies to all dimensions
+        std::vector<std::size_t> parseTileExtent(const Declaration& declaration) const
+        {
+            const auto annotation = declaration.annotations.find("tile");
+            const std::string tileExtentString = (annotation != declaration.annotations.end() ? annotation->second : tileExtent);
+            const std::size_t numDimensions = declaration.getNestingLevel() + 1;
+            std::vector<std::size_t> extent;
+
+            for (const auto& value : splitString(tileExtentString, 'x'))
+            {
+                char* end = nullptr;
+                const std::size_t result = std::strtoul(value.c_str(), &end, 10);
+
+                if (!(end && *end == '\0') || result == 0)
+                {
+                    std::cerr << "warning: invalid tile extent " << tileExtentString << ": " << declaration.decl.getNameAsString() << " -> no tiling" << std::endl;
+                    return std::vector<std::size_t>();
+                }
+
+                extent.push_back(result);
+            }
+
+            if (extent.size() == 1)
+            {
+                extent.resize(numDimensions, extent[0]);
+            }
+            else if (extent.size() != numDimensions)
+            {
+                std::cerr << "warning: tile extent " << tileExtentString << " does not match the " << numDimensions << " dimension(s) of " << declaration.decl.getNameAsString() << " -> no tiling" << std::endl;
+                return std::vector<std::size_t>();
+            }
+
+            // tiles do not exceed compile-time extents (declaration extents are ordered from the innermost to the outermost dimension)
+            if (declaration.hasConstantExtent())
+            {
+                for (std::size_t i = 0; i < numDimensions; ++i)
+                {
+                    extent[i] = std::min(extent[i], declaration.getExtent().at(numDimensions - 1 - i));
+                }
+            }
+
+            return extent;
+        }
+
+        // ghost layers 'trafo:halo=g' or 'trafo:halo=g_k x g_j x g_i' (from the outermost to the innermost dimension)
+        std::vector<std::size_t> parseHaloWidth(const Declaration& declaration, const std::string& order) const
+        {
+            const auto annotation = declaration.annotations.find("halo");
+            if (annotation == declaration.annotations.end()) return std::vector<std::size_t>();
+
+            const std::size_t numDimensions = declaration.getNestingLevel() + 1;
+            std::vector<std::size_t> width;
+
+            for (const auto& value : splitString(annotation->second, 'x'))
+            {
+                char* end = nullptr;
+                const std::size_t result = std::strtoul(value.c_str(), &end, 10);
+
+                if (!(end && *end == '\0') || value.length() == 0)
+                {
+                    std::cerr << "warning: invalid halo width " << annotation->second << ": " << declaration.decl.getNameAsString() << " -> no halo" << std::endl;
+                    return std::vector<std::size_t>();
+                }
+
+                width.push_back(result);
+            }
+
+            if (width.size() == 1)
+            {
+                width.resize(numDimensions, width[0]);
+            }
+            else if (width.size() != numDimensions)
+            {
+                std::cerr << "warning: halo width " << annotation->second << " does not match the " << numDimensions << " dimension(s) of " << declaration.decl.getNameAsString() << " -> no halo" << std::endl;
+                return std::vector<std::size_t>();
+            }
+
+            // the ghost layers extend the row-major index space
+            if (order != std::string("row_major"))
+            {
+                std::cerr << "warning: halos require row-major index order: " << declaration.decl.getNameAsString() << " -> no halo" << std::endl;
+                return std::vector<std::size_t>();
+            }
+
+            return width;
+        }
+
+        bool isConflictStride(const std::size_t strideInBytes) const
+        {
+            if (strideInBytes == 0 || cacheLineSize == 0 || (strideInBytes % cacheLineSize) != 0) return false;
+
+            // successive rows (streams) touch only numSets / gcd(strideInLines, numSets) different cache sets
+            std::size_t a = strideInBytes / cacheLineSize;
+            std::size_t b = std::max(cacheCriticalStride / cacheLineSize, static_cast<std::size_t>(1));
+            while (b != 0)
+            {
+                const std::size_t tmp = a % b;
+                a = b;
+                b = tmp;
+            }
+
+            return (a > 1);
+        }
+
+        // sizes of the (instantiated) field types by name, including the element types of array fields and the fields of nested records
+        static void addTypeSizes(const clang::CXXRecordDecl& recordDecl, std::map<std::string, std::size_t>& typeSizes)
+        {
+            const clang::ASTContext& context = recordDecl.getASTContext();
+
+            for (const auto field : recordDecl.fields())
+            {
+                clang::QualType type = field->getType();
+                const clang::CXXRecordDecl* const fieldRecordDecl = type->getAsCXXRecordDecl();
+                const clang::ClassTemplateSpecializationDecl* const specialization = llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(fieldRecordDecl);
+
+                if (const clang::ConstantArrayType* const arrayType = context.getAsConstantArrayType(type))
+                {
+                    type = arrayType->getElementType();
+                }
+                else if (specialization && specialization->isInStdNamespace() && specialization->getNameAsString() == std::string("array"))
+                {
+                    type = specialization->getTemplateArgs()[0].getAsType();
+                }
+                else if (fieldRecordDecl && fieldRecordDecl->hasDefinition() && !fieldRecordDecl->isInStdNamespace())
+                {
+                    addTypeSizes(*fieldRecordDecl, typeSizes);
+                    continue;
+                }
+
+                if (type->isDependentType() || type->isIncompleteType()) continue;
+
+                typeSizes[type.getUnqualifiedType().getAsString()] = context.getTypeSizeInChars(type).getQuantity();
+            }
+        }
+
+        // element size (in bytes) of the smallest stream of the buffer: array fields and nested records are flattened into
+        // streams of their elements, and fields may be stored narrowed, in bit streams or not at all (see getStreamLayout)
+        // returns 0 if the size of any stream is not known
+        std::size_t getSmallestStreamElementSize(const Declaration& declaration) const
+        {
+            const clang::CXXRecordDecl* const recordDecl = declaration.elementDataType->getAsCXXRecordDecl();
+            if (!recordDecl || !recordDecl->hasDefinition()) return 0;
+
+            const clang::ASTContext& context = declaration.decl.getASTContext();
+            const std::vector<clang::TemplateArgument> arguments = getTemplateArguments(declaration.elementDataType);
+
+            // built-in proxies store each component of the value type in a stream of its own
+            if (getBuiltinProxyName(declaration.elementDataType) != std::string(""))
+            {
+                return (arguments.size() > 0 && arguments[0].getKind() == clang::TemplateArgument::ArgKind::Type ? context.getTypeSizeInChars(arguments[0].getAsType()).getQuantity() : 0);
+            }
+
+            std::map<std::string, std::string> templateArguments;
+            const ClassMetaData::Definition* const definition = getDefinition(recordDecl->getNameAsString(), declaration.elementDataType, context, &templateArguments);
+            if (!definition) return 0;
+
+            // narrowed storage types and field types of the instantiated element type
+            std::map<std::string, std::size_t> typeSizes = {{"std::int8_t", 1}, {"std::uint8_t", 1}, {"std::int16_t", 2}, {"std::uint16_t", 2}, {"std::int32_t", 4}, {"std::uint32_t", 4},
+                {"std::int64_t", 8}, {"std::uint64_t", 8}, {"float", static_cast<std::size_t>(context.getTypeSizeInChars(context.FloatTy).getQuantity())}, {"XXX_NAMESPACE::half", 2}, {"XXX_NAMESPACE::bfloat16", 2}};
+            addTypeSizes(*recordDecl, typeSizes);
+
+            std::size_t scalarSize = 0;
+            for (std::string streamTypeName : getStreamLayout(*definition).streamTypeNames)
+            {
+                // bit streams are not padded in units of bytes
+                if (streamTypeName == bitStreamTypeName) continue;
+
+                for (const auto& templateArgument : templateArguments)
+                {
+                    findAndReplace(streamTypeName, templateArgument.first, templateArgument.second, true, true);
+                }
+
+                const auto typeSize = typeSizes.find(streamTypeName);
+                if (typeSize == typeSizes.end() || typeSize->second == 0) return 0;
+
+                scalarSize = (scalarSize == 0 ? typeSize->second : std::min(scalarSize, typeSize->second));
+            }
+
+            return scalarSize;
+        }
+
+        std::string generateConflictFreePadding(const Declaration& declaration, const std::vector<std::string>& extentString) const
+        {
+            if (!(conflictPadding || declaration.hasAnnotation("conflict_padding"))) return std::string("");
+
+            // the padding assumes row-major strides
+            if (getIndexOrder(declaration) != std::string("row_major")) return std::string("");
+
+            // the smallest stream element determines the granularity of the padding
+            const std::size_t scalarSize = getSmallestStreamElementSize(declaration);
+
+            if (scalarSize == 0 || (cacheLineSize % scalarSize) != 0) return std::string("");
+
+            const std::size_t numDimensions = declaration.getNestingLevel() + 1;
+            const std::size_t cacheLineElements = cacheLineSize / scalarSize;
+            std::stringstream padding;
+
+            // padding applies to the allocated extents, which include the ghost layers (innermost dimension first)
+            std::vector<std::size_t> haloWidth = getHaloWidth(declaration);
+            haloWidth.resize(numDimensions, 0);
+            std::reverse(haloWidth.begin(), haloWidth.end());
+
+            padding << "XXX_NAMESPACE::padding<" << numDimensions << ">";
+
+            if (declaration.hasConstantExtent())
+            {
+                // extents are ordered from the innermost to the outermost dimension: pad all but the outermost one
+                std::vector<std::size_t> dimensionPadding(numDimensions, 0);
+                std::size_t stride = scalarSize;
+                for (std::size_t i = 0; (i + 1) < numDimensions; ++i)
+                {
+                    const std::size_t extent = declaration.getExtent().at(i) + 2 * haloWidth[i];
+                    const std::size_t increment = (i == 0 ? cacheLineElements : 1);
+                    std::size_t paddedExtent = extent;
 
-                       it = functionsWithTargetParameters.erase(it);
-                       continue;
+                    // never pad by more than 8 increments
+                    while (isConflictStride(stride * paddedExtent) && paddedExtent < (extent + 8 * increment))
+                    {
+                        paddedExtent += increment;
                     }
 
-                    ++it;
+                    dimensionPadding[i] = paddedExtent - extent;
+                    stride *= paddedExtent;
                 }
 
-
-                if (functionsWithTargetParameters.size() > 0)
+                // stream offsets
+                const std::size_t streamSize = stride * (declaration.getExtent().at(numDimensions - 1) + 2 * haloWidth[numDimensions - 1]);
+                std::size_t streamPadding = 0;
+                while (isConflictStride(streamSize + streamPadding * scalarSize) && streamPadding < (8 * cacheLineElements))
                 {
-                    proxyClassCreator.insert(target->bottomMostSourceLocation.getLocWithOffset(1), std::string("\n\n#include \"") + std::string("autogen_") + target->name + std::string("_proxy_func.hpp\""));
+                    streamPadding += cacheLineElements;
                 }
 
+                padding << "{{";
+                for (std::size_t i = 0; i < numDimensions; ++i)
                 {
-                    std::string outputString;
-                    llvm::raw_string_ostream outputStream(outputString);
-                    
-                    proxyClassCreator.getEditBuffer(target->fileId).write(outputStream);
-
-                    std::string outputFilename(target->filename);
-
-                    if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
+                    padding << (i == 0 ? "" : ", ") << dimensionPadding[i];
+                }
+                padding << "}, " << streamPadding << "}";
+            }
+            else
+            {
+                // extents are known at runtime only: the buffer determines the padding from the cache geometry
+                padding << "::conflict_free<" << scalarSize << ">({{";
+                for (std::size_t i = 0; i < numDimensions; ++i)
+                {
+                    if (haloWidth[i] > 0)
                     {
-                        outputFilename = std::string(output_path);
+                        padding << (i == 0 ? "" : ", ") << "(" << extentString.at(i) << ") + " << 2 * haloWidth[i];
                     }
                     else
                     {
-                        const std::size_t pos = outputFilename.rfind('/');
-                        outputFilename = outputFilename.substr(0, pos) + std::string("/new_files");
-                    }
-                    outputFilename += (std::string("/autogen_") + target->name + std::string("_proxy.hpp"));
-                    
-                    std::ofstream out(outputFilename);
-                    if (out)
-                    {
-                        out << outputStream.str();
-                        out.close();
+                        padding << (i == 0 ? "" : ", ") << extentString.at(i);
                     }
-                    else
-                    {
-                        std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
-                    } 
                 }
+                padding << "}}, " << cacheLineSize << ", " << cacheCriticalStride << ")";
+            }
 
-                //////////////////////////////////////////////////////////////////////////////////////////////////////////
-                //////////////////////////////////////////////////////////////////////////////////////////////////////////
+            return padding.str();
+        }
 
-                // transform all remaining functions with target class parameters
-                std::stringstream globalFunctionString;
-                for (const auto& function : functionsWithTargetParameters)
-                {
-                    // deduce namespaces
-                    std::string fn;
-                    llvm::raw_string_ostream fullNameRawString(fn);
-                    function->getNameForDiagnostic(fullNameRawString, clang::PrintingPolicy(clang::LangOptions()), true);
-                    std::string fullName = fullNameRawString.str();
-                    std::vector<std::string> namespaces;
-                    std::size_t pos = fullName.find("::");
+        // extents (and padding) of a buffer: empty if the extents are not known
+        std::string generateBufferInitializer(const Declaration& declaration, const std::vector<std::string>& extentString) const
+        {
+            // jagged buffers: the number of rows only (the outermost extent)
+            if (isJaggedDeclaration(declaration))
+            {
+                return (extentString.size() > 0 ? (std::string("{{") + extentString.back() + std::string("}}")) : std::string(""));
+            }
 
-                    while (pos != std::string::npos)
-                    {
-                        namespaces.push_back(fullName.substr(0, pos));
-                        fullName = fullName.substr(pos + 2);
-                        pos = fullName.find("::");
-                    }
+            if (extentString.size() != (declaration.getNestingLevel() + 1)) return std::string("");
 
-                    // modify function signature
-                    const clang::FunctionTemplateDecl* templateFunctionDecl = function->getDescribedFunctionTemplate();
-                    const clang::SourceRange functionSourceRange = (templateFunctionDecl == nullptr ? function->getSourceRange() : templateFunctionDecl->getSourceRange());
-                    const std::string indent(getSpellingColumnNumber(functionSourceRange.getBegin(), context) - 1, ' ');
-                    const clang::SourceLocation parameterListBeginLoc = function->getParamDecl(0)->getSourceRange().getBegin();
-                    const clang::SourceLocation parameterListEndLoc = (function->hasBody() ? function->getBody()->getSourceRange().getBegin() : functionSourceRange.getEnd());
-                    std::string selection_1 = dumpSourceRangeToString({functionSourceRange.getBegin(), parameterListBeginLoc}, context.getSourceManager());
-                    std::string selection_2 = dumpSourceRangeToString({parameterListBeginLoc, parameterListEndLoc}, context.getSourceManager());
-                    std::string selection_3 = dumpSourceRangeToString({parameterListEndLoc, functionSourceRange.getEnd().getLocWithOffset(1)}, context.getSourceManager());
+            std::stringstream initializer;
+            initializer << "{{";
+            for (std::size_t i = 0; i <= declaration.getNestingLevel(); ++i)
+            {
+                initializer << (i == 0 ? "" : ", ") << extentString.at(i);
+            }
+            initializer << "}";
 
-                    std::string proxyTypeNamespacePrefix;
-                    for (const auto& ns : target->getDeclaration().namespaces)
-                    {
-                        proxyTypeNamespacePrefix += ns.name;
-                    }
-                    proxyTypeNamespacePrefix += std::string("::");
-                    std::string proxyTypeName = proxyTypeNamespacePrefix + proxyNamespace + std::string("::") + target->name + std::string("_proxy");
+            // logical extents stay the same: padding affects the memory layout only
+            const std::string padding = generateConflictFreePadding(declaration, extentString);
+            if (padding.length())
+            {
+                initializer << ", " << padding;
+            }
+            initializer << "}";
 
-                    if (function->getDeclaredReturnType()->isReferenceType())
-                    {
-                        findAndReplace(selection_1, proxyTypeNamespacePrefix + target->name, proxyTypeName, true, true);
-                        findAndReplace(selection_1, target->name, proxyTypeName, true, true);
-                    }
-                    findAndReplace(selection_2, proxyTypeNamespacePrefix + target->name, proxyTypeName, true, true);
-                    findAndReplace(selection_2, target->name, proxyTypeName, true, true);
-                    const std::size_t numNamespaces = namespaces.size();
+            return initializer.str();
+        }
 
-                    std::string extIndent;
-                    for (std::size_t i = 0; i < numNamespaces; ++i)
-                    {
-                        globalFunctionString << extIndent << "namespace " << namespaces[i] << "\n";
-                        globalFunctionString << extIndent << "{\n";
+        std::string generateBufferTypeName(const Declaration& declaration) const
+        {
+            std::stringstream typeName;
+            if (isJaggedDeclaration(declaration))
+            {
+                // one offsets array plus flattened field streams: v[i] is a row view, v[i][j] a proxy
+                typeName << "XXX_NAMESPACE::jagged_buffer<" << declaration.elementDataTypeSpelling << ", ";
+            }
+            else
+            {
+                typeName << "XXX_NAMESPACE::buffer<" << declaration.elementDataTypeSpelling << ", ";
+                typeName << declaration.getNestingLevel() + 1 << ", ";
+            }
+            typeName << "XXX_NAMESPACE::data_layout::SoA";
+            for (const auto& policy : getBufferPolicies(declaration))
+            {
+                typeName << ", " << policy;
+            }
+            typeName << ">";
 
-                        extIndent += indent;
-                    }
+            return typeName.str();
+        }
 
-                    globalFunctionString << extIndent << selection_1;
-                    globalFunctionString << selection_2;
-                    globalFunctionString << selection_3 << std::endl;
+        std::string generateBufferDeclaration(const Declaration& declaration) const
+        {
+            std::stringstream newDeclaration;
+            newDeclaration << generateBufferTypeName(declaration) << " ";
+            newDeclaration << declaration.decl.getNameAsString();
 
-                    if (numNamespaces > 0)
-                    {
-                        for (std::size_t i = (numNamespaces - 1); i >= 0; --i)
-                        {
-                            extIndent = std::string("");
-                            for (std::size_t j = 0; j < i; ++j)
-                            {
-                                extIndent += indent;
-                            }
-                            globalFunctionString << extIndent << "}\n\n";
+            bool nonZeroExtent = true;
+            for (std::size_t i = 0; i <= declaration.getNestingLevel(); ++i)
+            {
+                nonZeroExtent &= (declaration.getExtent().at(i) != 0);
+            }
 
-                            if (i == 0) break;  
-                        }
-                    }
+            if (nonZeroExtent)
+            {
+                newDeclaration << generateBufferInitializer(declaration, declaration.getExtentString());
+            }
+            newDeclaration << ";";
+
+            // 'calloc', 'make_unique<T[]>(n)', 'new T[n]()' and 'new T[n]' of non-trivial types initialize the elements
+            if (declaration.isHeapArrayDeclaration() && static_cast<const HeapArrayDeclaration&>(declaration).isInitializingAllocation)
+            {
+                const std::string name = declaration.decl.getNameAsString();
+                newDeclaration << " std::fill(" << name << ".begin(), " << name << ".end(), " << declaration.elementDataTypeSpelling << "());";
+            }
+
+            return newDeclaration.str();
+        }
+
+        // extents from constructor initializers like 'particles(n)' or 'cells(n, std::vector<cell>(m))' (innermost dimension first)
+        // 'numLevels' restricts the parsing to the outermost containers
+        std::vector<std::string> getExtentStringFromInitializer(const Declaration& declaration, const clang::Expr* init, clang::ASTContext& context, const std::uint32_t numLevels = std::numeric_limits<std::uint32_t>::max()) const
+        {
+            std::vector<std::string> extentString;
+            clang::QualType type = declaration.decl.getType();
+            const clang::Expr* expr = init;
+
+            for (std::uint32_t level = 0; level <= declaration.getNestingLevel() && level < numLevels; ++level)
+            {
+                const clang::ClassTemplateSpecializationDecl* const containerDecl = (type.isNull() ? nullptr : llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(type->getAsCXXRecordDecl()));
+                const ContainerDescriptor* const descriptor = (containerDecl ? ContainerDescriptor::find(containerDescriptors, containerDecl->getNameAsString()) : nullptr);
+                if (!descriptor) return std::vector<std::string>();
+
+                if (descriptor->hasFixedSize())
+                {
+                    // fixed-size arrays: the extent is part of the type
+                    extentString.insert(extentString.begin(), declaration.getExtentString().at(declaration.getNestingLevel() - level));
+                    expr = nullptr;
                 }
+                else
+                {
+                    // there must be an argument with the number of elements (not a copy or an initializer list)
+                    const clang::CXXConstructExpr* const constructExpr = llvm::dyn_cast_or_null<clang::CXXConstructExpr>(expr ? expr->IgnoreImplicit() : nullptr);
+                    const std::int32_t extentArgument = (constructExpr ? descriptor->getExtentArgument(*constructExpr) : -1);
+                    if (extentArgument < 0) return std::vector<std::string>();
 
-                // write to file
-                if (functionsWithTargetParameters.size() > 0)
+                    extentString.insert(extentString.begin(), dumpTokenRangeToString(constructExpr->getArg(extentArgument)->getSourceRange(), context.getSourceManager()));
+
+                    // the value of all elements (if any): an inner container gives the next extent
+                    const std::int32_t valueArgument = descriptor->getValueArgument(*constructExpr, containerDecl->getTemplateArgs().get(descriptor->elementTypeArgument).getAsType(), context);
+                    expr = (valueArgument >= 0 ? constructExpr->getArg(valueArgument) : nullptr);
+                }
+
+                type = containerDecl->getTemplateArgs().get(descriptor->elementTypeArgument).getAsType();
+            }
+
+            return extentString;
+        }
+
+        // data members get their extents in the constructor initializer lists
+        void modifyConstructorInitializers(const Declaration& declaration, std::set<clang::FileID>& outputFiles, clang::ASTContext& context)
+        {
+            const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(&declaration.decl);
+            if (!fieldDecl) return;
+
+            const clang::SourceManager& sourceManager = context.getSourceManager();
+            const clang::CXXRecordDecl* const recordDecl = llvm::dyn_cast<clang::CXXRecordDecl>(fieldDecl->getParent());
+            if (!recordDecl) return;
+
+            for (const auto constructor : recordDecl->ctors())
+            {
+                // initializers are attached to the definition, which might be out of line
+                const clang::FunctionDecl* definition = nullptr;
+                if (!constructor->hasBody(definition)) continue;
+
+                const clang::CXXConstructorDecl* const constructorDefinition = llvm::dyn_cast<clang::CXXConstructorDecl>(definition);
+                if (!constructorDefinition || constructorDefinition->isImplicit()) continue;
+
+                for (const auto initializer : constructorDefinition->inits())
                 {
-                    std::string outputFilename(target->filename);
+                    if (!initializer->isWritten() || initializer->getMember() != fieldDecl) continue;
 
-                    if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
-                    {
-                        outputFilename = std::string(output_path);
-                    }
-                    else
+                    const std::uint32_t numLevels = (isJaggedDeclaration(declaration) ? 1 : std::numeric_limits<std::uint32_t>::max());
+                    std::vector<std::string> extentString = (declaration.hasConstantExtent() ? declaration.getExtentString() : getExtentStringFromInitializer(declaration, initializer->getInit(), context, numLevels));
+                    if (extentString.size() == 0)
                     {
-                        const std::size_t pos = outputFilename.rfind('/');
-                        outputFilename = outputFilename.substr(0, pos) + std::string("/new_files");
+                        std::cerr << "warning: unable to determine the extents of " << declaration.decl.getNameAsString() << " in " << initializer->getSourceRange().printToString(sourceManager) << " -> buffer is default constructed" << std::endl;
                     }
-                    outputFilename += (std::string("/autogen_") + target->name + std::string("_proxy_func.hpp"));
 
-                    std::ofstream out(outputFilename);
-                    if (out)
-                    {
-                        out << globalFunctionString.str();
-                        out.close();
-                    }
-                    else
-                    {
-                        std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
-                    }
+                    const clang::SourceRange sourceRange(initializer->getMemberLocation(), initializer->getRParenLoc());
+                    const clang::FileID fileId = sourceManager.getFileID(sourceRange.getBegin());
+                    const std::string newInitializer = generateBufferInitializer(declaration, extentString);
+
+                    rewriter.getEditBuffer(fileId).ReplaceText(sourceManager.getFileOffset(sourceRange.getBegin()), sourceManager.getFileOffset(sourceRange.getEnd()) + 1 - sourceManager.getFileOffset(sourceRange.getBegin()),
+                        declaration.decl.getNameAsString() + (newInitializer.length() ? newInitializer : std::string("()")));
+                    outputFiles.insert(fileId);
                 }
             }
         }
 
-        void modifyIncludeStatements(const std::vector<std::unique_ptr<ClassMetaData>>& proxyClassTargets, clang::ASTContext& context)
+        void writeBuiltinProxyHeader(const std::string& referenceFilename)
         {
-            for (const auto& target : proxyClassTargets)
+            std::string outputFilename(referenceFilename);
+
+            if (const char* output_path = secure_getenv("CODE_TRAFO_OUTPUT_PATH"))
             {
-                const clang::SourceLocation includeLocation = target->sourceManager.getIncludeLoc(target->fileId);
-                const clang::SourceLocation includeLineBegin = getBeginOfLine(includeLocation, target->context);
-                const clang::SourceLocation includeLineEnd = getNextLine(includeLocation, target->context).getLocWithOffset(-1);
-                const std::size_t includeLineLength = getSpellingColumnNumber(includeLineEnd, target->context) - getSpellingColumnNumber(includeLineBegin, target->context);
+                outputFilename = std::string(output_path);
+            }
+            else
+            {
+                const std::size_t pos = outputFilename.rfind('/');
+                outputFilename = (pos != std::string::npos ? outputFilename.substr(0, pos) + std::string("/new_files") : std::string("new_files"));
+            }
+            outputFilename += std::string("/autogen_builtin_proxy.hpp");
 
-                clang::RewriteBuffer& rewriteBuffer = rewriter.getEditBuffer(target->sourceManager.getFileID(includeLocation));
-                rewriteBuffer.ReplaceText(target->sourceManager.getFileOffset(includeLineBegin), includeLineLength, std::string("#include \"") + target->name + std::string(".hpp\""));
-                rewriteBuffer.InsertTextBefore(target->sourceManager.getFileOffset(includeLineBegin), std::string("#include <buffer/buffer.hpp>\n"));
+            std::ofstream out(outputFilename);
+            if (out)
+            {
+                out << generateBuiltinProxyHeader();
+                out.close();
+            }
+            else
+            {
+                std::cerr << "error: unable to open file " << outputFilename << std::endl << std::flush;
             }
         }
 
         void modifyDeclarations(clang::ASTContext& context)
         {
             std::set<clang::FileID> outputFiles;
+            std::set<clang::FileID> builtinProxyFiles;
             const clang::SourceManager& sourceManager = context.getSourceManager();
 
             for (const auto& declaration : declarations)
@@ -1265,30 +4045,78 @@ namespace TRAFO_NAMESPACE
                 clang::RewriteBuffer& rewriteBuffer = rewriter.getEditBuffer(fileId);
                 outputFiles.insert(fileId);
 
-                std::stringstream newDeclaration;
-                newDeclaration << "XXX_NAMESPACE::buffer<" << declaration->elementDataType.getAsString() << ", ";
-                newDeclaration << declaration->getNestingLevel() + 1 << ", ";
-                newDeclaration << "XXX_NAMESPACE::data_layout::SoA> ";
-                newDeclaration << declaration->decl.getNameAsString();
+                rewriteBuffer.ReplaceText(context.getSourceManager().getFileOffset(declBegin), declLength, generateBufferDeclaration(*declaration));
 
-                bool nonZeroExtent = true;
-                for (std::size_t i = 0; i <= declaration->getNestingLevel(); ++i)
+                if (declaration->isFieldDeclaration())
                 {
-                    nonZeroExtent &= (declaration->getExtent().at(i) != 0);
+                    modifyConstructorInitializers(*declaration, outputFiles, context);
                 }
 
-                if (nonZeroExtent)
+                if (getBuiltinProxyName(declaration->elementDataType) != std::string("") && builtinProxyFiles.insert(fileId).second)
                 {
-                    newDeclaration << "{{";
-                    for (std::size_t i = 0; i <= declaration->getNestingLevel(); ++i)
-                    {
-                        newDeclaration << (i == 0 ? "" : ", ") << declaration->getExtentString().at(i);
-                    }
-                    newDeclaration << "}}";
+                    rewriteBuffer.InsertTextBefore(0, std::string("#include <buffer/buffer.hpp>\n#include \"autogen_builtin_proxy.hpp\"\n"));
+                }
+            }
+
+            modifyAppendCalls(outputFiles, context);
+            modifyElementReferences(outputFiles, context);
+            modifyComplexMathCalls(outputFiles, context);
+            removeDeadFieldWrites(outputFiles, context);
+
+            // functions taking the transformed declarations as arguments get buffer or view parameters
+            parameterPropagation->printInfo();
+            parameterPropagation->printWarnings();
+            parameterPropagation->modifyFunctions(rewriter, outputFiles);
+
+            // loop nests over tiled buffers walk them tile by tile
+            std::map<const clang::ValueDecl*, std::vector<std::size_t>> tileExtents;
+            for (const auto& declaration : declarations)
+            {
+                if (getIndexOrder(*declaration) == std::string("tiled") && getTileExtent(*declaration).size() > 0)
+                {
+                    tileExtents[&declaration->decl] = getTileExtent(*declaration);
+                }
+            }
+
+            for (const auto& parameter : propagatedParameters)
+            {
+                const auto tileExtent = tileExtents.find(&parameter.second->decl);
+                if (tileExtent != tileExtents.end())
+                {
+                    tileExtents[parameter.first] = tileExtent->second;
                 }
-                newDeclaration << ";";
+            }
+
+            for (const auto& pattern : templatePatterns)
+            {
+                const auto tileExtent = tileExtents.find(pattern.second);
+                if (tileExtent != tileExtents.end())
+                {
+                    tileExtents[pattern.first] = tileExtent->second;
+                }
+            }
+
+            if (tileExtents.size() > 0)
+            {
+                LoopTiling loopTiling(tileExtents, context);
+                loopTiling.printInfo();
+                loopTiling.modifyLoops(rewriter, outputFiles);
+            }
+
+            // buffers release their memory themselves
+            for (const auto& deallocation : deallocations)
+            {
+                const clang::SourceRange sourceRange = getSourceRangeWithClosingCharacter(deallocation, std::string(";"), context, true);
+                const clang::FileID fileId = sourceManager.getFileID(sourceRange.getBegin());
+                const std::size_t offset = sourceManager.getFileOffset(sourceRange.getBegin());
+
+                rewriter.getEditBuffer(fileId).RemoveText(offset, sourceManager.getFileOffset(sourceRange.getEnd()) + 1 - offset);
+                outputFiles.insert(fileId);
+            }
 
-                rewriteBuffer.ReplaceText(context.getSourceManager().getFileOffset(declBegin), declLength, newDeclaration.str());
+            if (builtinProxyFiles.size() > 0)
+            {
+                writeBuiltinProxyHeader(sourceManager.getFilename(sourceManager.getLocForStartOfFile(*builtinProxyFiles.begin())).str());
             }
 
             for (const clang::FileID fileId : outputFiles)
@@ -1326,9 +4154,22 @@ namespace TRAFO_NAMESPACE
 
     public:
         
-        InsertProxyClassImplementation(clang::Rewriter& clangRewriter)
+        InsertProxyClassImplementation(clang::Rewriter& clangRewriter, const bool isAnalysisPass = false)
             :
-            rewriter(clangRewriter)
+            rewriter(clangRewriter),
+            isAnalysisPass(isAnalysisPass),
+            containerDescriptors(getContainerDescriptors()),
+            usesBuiltinProxies(false),
+            streamAlignment(getStreamAlignment()),
+            fieldClustering(getEnvironmentVariableAsInteger("CODE_TRAFO_FIELD_CLUSTERING", 0) != 0),
+            deadFieldElimination(getEnvironmentVariableAsInteger("CODE_TRAFO_DEAD_FIELD_ELIMINATION", 0) != 0),
+            packedStreams(getEnvironmentVariableAsInteger("CODE_TRAFO_PACKED_STREAMS", 0) != 0),
+            narrowEnums(getEnvironmentVariableAsInteger("CODE_TRAFO_NARROW_ENUMS", 0) != 0),
+            indexOrder(getIndexOrder()),
+            tileExtent(getEnvironmentVariable("CODE_TRAFO_TILE_EXTENT", std::string("8"))),
+            conflictPadding(getEnvironmentVariableAsInteger("CODE_TRAFO_CONFLICT_PADDING", 0) != 0),
+            cacheLineSize(getEnvironmentVariableAsInteger("CODE_TRAFO_CACHE_LINE_SIZE", 64)),
+            cacheCriticalStride(getCacheCriticalStride())
         { ; }
 
         ~InsertProxyClassImplementation()
@@ -1351,16 +4192,57 @@ namespace TRAFO_NAMESPACE
             }
         }
 
+        // field clustering and dead field elimination need the field accesses of all translation units before any of them is transformed
+        static bool requiresFieldAccessAnalysis()
+        {
+            return (getEnvironmentVariableAsInteger("CODE_TRAFO_FIELD_CLUSTERING", 0) != 0 || getEnvironmentVariableAsInteger("CODE_TRAFO_DEAD_FIELD_ELIMINATION", 0) != 0);
+        }
+
+        static void completeFieldAccessAnalysis()
+        {
+            FieldAccessAnalysis::setProgramComplete();
+        }
+
         void HandleTranslationUnit(clang::ASTContext& context) override
         {	
+            if (isAnalysisPass)
+            {
+                // problems are reported when the translation unit is transformed
+                std::streambuf* const errorBuffer = std::cerr.rdbuf(nullptr);
+
+                if (matchDeclarations(context))
+                {
+                    FieldAccessAnalysis(declarations, context).addToProgram();
+                }
+
+                std::cerr.rdbuf(errorBuffer);
+                return;
+            }
+
             // step 1: find all relevant container declarations
-            std::vector<std::string> containerNames;
-            containerNames.push_back(std::string("vector"));
-            containerNames.push_back(std::string("array"));
-            if (!matchDeclarations(containerNames, context)) return;
+            if (!matchDeclarations(context)) return;
+
+            // step 2: check if element data type is candidate for proxy class generation (built-in proxy types need no check)
+            const bool hasProxyClassTargets = findProxyClassTargets(context);
+            if (!(hasProxyClassTargets || usesBuiltinProxies)) return;
+
+            // step 2a: sort out proxy class targets with nested records that cannot be transformed
+            checkNestedProxyClassTargets();
+
+            // step 2b: report races on bit-packed fields
+            checkBitPackedFieldWrites(context);
+
+            // step 2c: field writes that are dropped, as well as the fields that are read and that are accessed together inside loops in any translation unit
+            if (fieldClustering || deadFieldElimination)
+            {
+                if (!FieldAccessAnalysis::hasProgramFieldAccesses())
+                {
+                    std::cerr << "warning: field clustering and dead field elimination need the field accesses of all translation units (AnalyzeFieldAccess) -> disabled" << std::endl;
+                }
 
-            // step 2: check if element data type is candidate for proxy class generation
-            if (!findProxyClassTargets(context)) return;
+                fieldAccessAnalysis.reset(new FieldAccessAnalysis(declarations, context));
+                FieldAccessAnalysis::printInfo();
+            }
 
             // step 3: add proxy classes
             addProxyClassToSource(proxyClassTargets, context);
@@ -1399,6 +4281,22 @@ namespace TRAFO_NAMESPACE
             return llvm::make_unique<InsertProxyClassImplementation>(rewriter);
         }
     };
+
+    // first pass: collect the field accesses of all translation units, nothing is rewritten
+    class AnalyzeFieldAccess : public clang::ASTFrontendAction
+    {
+        clang::Rewriter rewriter;
+
+    public:
+
+        AnalyzeFieldAccess() { ; }
+
+        std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance& compilerInstance, llvm::StringRef file) override
+        {
+            rewriter.setSourceMgr(compilerInstance.getSourceManager(), compilerInstance.getLangOpts());
+            return llvm::make_unique<InsertProxyClassImplementation>(rewriter, true);
+        }
+    };
 }
 
 #endif
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <map>
 #include <vector>
 #include <misc/ast_helper.hpp>
 
@@ -19,6 +20,80 @@ namespace TRAFO_NAMESPACE
 {
     namespace internal
     {
+        // containers that can be transformed: the element type is a template argument, the extent is given
+        // either by a template argument (fixed size) or by a constructor argument (dynamic size)
+        struct ContainerDescriptor
+        {
+            std::string name;
+            std::size_t elementTypeArgument;
+            std::int32_t extentTemplateArgument;
+            std::int32_t extentConstructorArgument;
+            // storage in chunks (std::deque)
+            bool isChunked;
+
+            ContainerDescriptor(const std::string& name, const std::size_t elementTypeArgument, const std::int32_t extentTemplateArgument, const std::int32_t extentConstructorArgument, const bool isChunked = false)
+                :
+                name(name),
+                elementTypeArgument(elementTypeArgument),
+                extentTemplateArgument(extentTemplateArgument),
+                extentConstructorArgument(extentConstructorArgument),
+                isChunked(isChunked)
+            { ; }
+
+            bool hasFixedSize() const { return (extentTemplateArgument >= 0); }
+
+            // constructor argument with the number of elements (-1 if there is none): the count is an integer taken by value, while element values are
+            // taken by reference. this selects the overload, e.g. 'vector(size_type n, const T& value)', but 'valarray(const T& value, size_t n)'
+            std::int32_t getExtentArgument(const clang::CXXConstructExpr& constructExpr) const
+            {
+                if (hasFixedSize() || extentConstructorArgument < 0) return -1;
+
+                const clang::CXXConstructorDecl* const constructor = constructExpr.getConstructor();
+                const auto isCount = [&constructExpr, constructor] (const std::uint32_t i)
+                {
+                    if (i >= constructExpr.getNumArgs() || llvm::isa<clang::CXXDefaultArgExpr>(constructExpr.getArg(i))) return false;
+                    if (!constructExpr.getArg(i)->getType()->isIntegerType()) return false;
+
+                    return (!constructor || i >= constructor->getNumParams() || !constructor->getParamDecl(i)->getType()->isReferenceType());
+                };
+
+                if (isCount(extentConstructorArgument)) return extentConstructorArgument;
+
+                for (std::uint32_t i = 0; i < constructExpr.getNumArgs(); ++i)
+                {
+                    if (isCount(i)) return i;
+                }
+
+                return -1;
+            }
+
+            // constructor argument with the value of all elements (-1 if there is none), e.g. 'std::vector<T>(m)' in 'v(n, std::vector<T>(m))'
+            std::int32_t getValueArgument(const clang::CXXConstructExpr& constructExpr, const clang::QualType& elementType, const clang::ASTContext& context) const
+            {
+                const std::int32_t extentArgument = getExtentArgument(constructExpr);
+                if (extentArgument < 0) return -1;
+
+                for (std::uint32_t i = 0; i < constructExpr.getNumArgs(); ++i)
+                {
+                    const clang::Expr* const argument = constructExpr.getArg(i);
+
+                    if (static_cast<std::int32_t>(i) != extentArgument && !llvm::isa<clang::CXXDefaultArgExpr>(argument) && context.hasSameUnqualifiedType(argument->getType(), elementType)) return i;
+                }
+
+                return -1;
+            }
+
+            static const ContainerDescriptor* find(const std::vector<ContainerDescriptor>& descriptors, const std::string& name)
+            {
+                for (const auto& descriptor : descriptors)
+                {
+                    if (descriptor.name == name) return &descriptor;
+                }
+
+                return nullptr;
+            }
+        };
+
         class Declaration
         {
             std::string getDataTypeName(const clang::QualType& dataType)
@@ -37,20 +112,26 @@ namespace TRAFO_NAMESPACE
 
         public:
 
-            const clang::VarDecl& decl;
+            // variable or data member declaration
+            const clang::DeclaratorDecl& decl;
             const clang::SourceRange sourceRange;
             const clang::QualType elementDataType;
             const std::string elementDataTypeName;
             std::string elementDataTypeNamespace;
+            const std::map<std::string, std::string> annotations;
+            // element type in the generated code: inside templates it is spelled as written (e.g. 'fw::vec<T, 3>')
+            std::string elementDataTypeSpelling;
 
         protected:
 
-            Declaration(const clang::VarDecl& decl, const clang::QualType elementDataType)
+            Declaration(const clang::DeclaratorDecl& decl, const clang::QualType elementDataType)
                 :
                 decl(decl),
                 sourceRange(getSourceRangeWithClosingCharacter(decl.getSourceRange(), std::string(";"), decl.getASTContext(), true)),
                 elementDataType(elementDataType),
-                elementDataTypeName(getDataTypeName(elementDataType))
+                elementDataTypeName(getDataTypeName(elementDataType)),
+                annotations(getAnnotations(decl)),
+                elementDataTypeSpelling(elementDataType.isNull() ? std::string("") : elementDataType.getAsString())
             {
                 if (!elementDataType.isNull())
                 {
@@ -72,22 +153,45 @@ namespace TRAFO_NAMESPACE
 
             virtual bool isScalarTypeDeclaration() const { return true; }
 
+            bool isFieldDeclaration() const { return llvm::isa<clang::FieldDecl>(decl); }
+
+            // the tool is built without RTTI
+            virtual bool isContainerDeclaration() const { return false; }
+
+            virtual bool isHeapArrayDeclaration() const { return false; }
+
             virtual std::uint32_t getNestingLevel() const { return 0; }
 
             virtual const std::vector<std::size_t>& getExtent() const = 0;
 
             virtual const std::vector<std::string>& getExtentString() const = 0;
 
+            // are all extents known at compile time?
+            virtual bool hasConstantExtent() const = 0;
+
+            bool hasAnnotation(const std::string& key) const
+            {
+                return (annotations.find(key) != annotations.end());
+            }
+
             virtual void printInfo(const clang::SourceManager& sourceManager, const std::string indent = std::string("")) const
             {
-                std::cout << indent << "* variable name: " << decl.getNameAsString() << std::endl;
+                std::cout << indent << "* " << (isFieldDeclaration() ? "field" : "variable") << " name: " << decl.getNameAsString() << std::endl;
                 std::cout << indent << "* range: " << sourceRange.printToString(sourceManager) << std::endl;
                 std::cout << indent << "* element data type: " << elementDataType.getAsString();
                 if (elementDataType.getAsString() != elementDataTypeName)
                 {
                     std::cout << " (" <<  elementDataTypeNamespace << elementDataTypeName << ")";
                 }
+                if (elementDataTypeSpelling != elementDataType.getAsString())
+                {
+                    std::cout << ", spelled " << elementDataTypeSpelling;
+                }
                 std::cout << std::endl;
+                for (const auto& annotation : annotations)
+                {
+                    std::cout << indent << "* annotation: " << annotation.first << (annotation.second.length() ? (std::string("=") + annotation.second) : std::string("")) << std::endl;
+                }
             }
         };
 
@@ -109,7 +213,7 @@ namespace TRAFO_NAMESPACE
             const std::vector<std::size_t> extent;
             const std::vector<std::string> extentString;
 
-            ConstantArrayDeclaration(const clang::VarDecl& decl, const bool isNested, const std::uint32_t nestingLevel, const clang::QualType elementDataType, const std::vector<std::size_t>& extent, const std::vector<std::string>& extentString)
+            ConstantArrayDeclaration(const clang::DeclaratorDecl& decl, const bool isNested, const std::uint32_t nestingLevel, const clang::QualType elementDataType, const std::vector<std::size_t>& extent, const std::vector<std::string>& extentString)
                 :
                 Base(decl, elementDataType),
                 arrayType(decl.getType()),
@@ -129,7 +233,9 @@ namespace TRAFO_NAMESPACE
 
             const std::vector<std::string>& getExtentString() const { return extentString; }
 
-            static ConstantArrayDeclaration make(const clang::VarDecl& decl, clang::ASTContext& context)
+            bool hasConstantExtent() const { return true; }
+
+            static ConstantArrayDeclaration make(const clang::DeclaratorDecl& decl, clang::ASTContext& context)
             {
                 clang::QualType elementDataType;
                 bool isNested = false;
@@ -220,85 +326,106 @@ namespace TRAFO_NAMESPACE
             const std::uint32_t nestingLevel;
             const std::vector<std::size_t> extent;
             const std::vector<std::string> extentString;
+            const bool isConstantExtent;
 
-            ContainerDeclaration(const clang::VarDecl& decl, const bool isNested, const std::uint32_t nestingLevel, const clang::QualType elementDataType, const std::vector<std::size_t>& extent, const std::vector<std::string>& extentString)
+            ContainerDeclaration(const clang::DeclaratorDecl& decl, const bool isNested, const std::uint32_t nestingLevel, const clang::QualType elementDataType, const std::vector<std::size_t>& extent, const std::vector<std::string>& extentString, const bool isConstantExtent)
                 :
                 Base(decl, elementDataType),
                 containerType(decl.getType()),
                 isNested(isNested),
                 nestingLevel(nestingLevel),
                 extent(extent),
-                extentString(extentString)
+                extentString(extentString),
+                isConstantExtent(isConstantExtent)
             { ; }
 
             ~ContainerDeclaration() { ; }
 
             bool isScalarTypeDeclaration() const { return true; }
 
+            bool isContainerDeclaration() const { return true; }
+
             std::uint32_t getNestingLevel() const { return nestingLevel; }
 
             const std::vector<std::size_t>& getExtent() const { return extent; }
 
             const std::vector<std::string>& getExtentString() const { return extentString; }
 
-            static ContainerDeclaration make(const clang::VarDecl& decl, clang::ASTContext& context, const std::vector<std::string>& containerNames)
+            bool hasConstantExtent() const { return isConstantExtent; }
+
+            static ContainerDeclaration make(const clang::DeclaratorDecl& decl, clang::ASTContext& context, const std::vector<ContainerDescriptor>& containerDescriptors)
             {
                 clang::QualType elementDataType;
-                const clang::SourceRange sourceRange = getSourceRangeWithClosingCharacter(decl.getSourceRange(), std::string(";"), decl.getASTContext(), true);
                 std::string fullName = decl.getType().getAsString();
                 std::string name = decl.getType()->getAsRecordDecl()->getNameAsString();
+                const ContainerDescriptor* descriptor = ContainerDescriptor::find(containerDescriptors, name);
                 const clang::Type* type = decl.getType().getTypePtrOrNull();
                 bool isNested = false;
                 std::uint32_t nestingLevel = 0;
                 std::vector<std::size_t> extent;
                 std::vector<std::string> extentString;
+                bool isConstantExtent = true;
+
+                // constructor call of the current nesting level: the declaration itself, then the value of all elements of the enclosing container
+                const clang::Expr* init = nullptr;
+                if (const clang::VarDecl* const varDecl = llvm::dyn_cast<clang::VarDecl>(&decl))
+                {
+                    init = varDecl->getInit();
+                }
+                else if (const clang::FieldDecl* const fieldDecl = llvm::dyn_cast<clang::FieldDecl>(&decl))
+                {
+                    init = fieldDecl->getInClassInitializer();
+                }
 
                 // check for nested container declaration
                 // note: in the first instance 'type' is either a class or structur type (it is the container type itself)
-                while (type)
+                while (type && descriptor)
                 {
                     // we can do this as any variable declaration of the container is a specialzation of containerType<T,..>
-                    if (const clang::TemplateSpecializationType* const tsType = type->getAs<clang::TemplateSpecializationType>())
+                    const clang::TemplateSpecializationType* const tsType = type->getAs<clang::TemplateSpecializationType>();
+                    if (tsType && tsType->getNumArgs() > descriptor->elementTypeArgument)
                     {
                         // if the container is an array of fixed size...
                         std::size_t value = 0;
                         std::string valueString("");
-                        if (name == std::string("array"))
+                        if (descriptor->hasFixedSize())
                         {
-                            // get the extent: 2nd template parameter
-                            if (tsType->getArg(1).getKind() == clang::TemplateArgument::ArgKind::Integral)
+                            // get the extent from the template argument
+                            const std::size_t argument = descriptor->extentTemplateArgument;
+                            if (argument < tsType->getNumArgs() && tsType->getArg(argument).getKind() == clang::TemplateArgument::ArgKind::Integral)
                             {
-                                value = tsType->getArg(1).getAsIntegral().getExtValue();
+                                value = tsType->getArg(argument).getAsIntegral().getExtValue();
                             }
-                            else if (tsType->getArg(1).getKind() == clang::TemplateArgument::ArgKind::Expression)
+                            else if (argument < tsType->getNumArgs() && tsType->getArg(argument).getKind() == clang::TemplateArgument::ArgKind::Expression)
                             {
-                                const clang::Expr* const expr = tsType->getArg(1).getAsExpr();
+                                const clang::Expr* const expr = tsType->getArg(argument).getAsExpr();
                                 value = (expr ? expr->EvaluateKnownConstInt(context).getExtValue() : 0);
                             }
 
                             valueString = std::to_string(value);
+                            init = nullptr;
                         }
-                        else if (name == std::string("vector"))
+
+                        // the element type is one of the template arguments of the container
+                        clang::QualType taQualType = tsType->getArg(descriptor->elementTypeArgument).getAsType();
+
+                        if (!descriptor->hasFixedSize())
                         {
-                            std::string declString = dumpSourceRangeToString(sourceRange, decl.getASTContext().getSourceManager());                        
-                            std::size_t firstArgumentBeginPos = declString.find('(', declString.find(decl.getNameAsString()));                            
-                            std::size_t firstArgumentEndPos = declString.find(',', firstArgumentBeginPos);
-                            if (firstArgumentEndPos == std::string::npos)
-                            {
-                                firstArgumentEndPos = declString.find(')', firstArgumentBeginPos);
-                            }
+                            isConstantExtent = false;
+                            const clang::CXXConstructExpr* const constructExpr = llvm::dyn_cast_or_null<clang::CXXConstructExpr>(init ? init->IgnoreImplicit() : nullptr);
+                            const std::int32_t extentArgument = (constructExpr ? descriptor->getExtentArgument(*constructExpr) : -1);
+                            const std::int32_t valueArgument = (constructExpr ? descriptor->getValueArgument(*constructExpr, taQualType, context) : -1);
 
-                            if (firstArgumentBeginPos != std::string::npos && firstArgumentEndPos != std::string::npos)
+                            if (extentArgument >= 0)
                             {
                                 value = 1; // TODO: remove that! this is just to indicate that there is an argument
-                                valueString = declString.substr(firstArgumentBeginPos + 1, firstArgumentEndPos - firstArgumentBeginPos - 1);
+                                valueString = dumpTokenRangeToString(constructExpr->getArg(extentArgument)->getSourceRange(), context.getSourceManager());
                             }
+
+                            init = (valueArgument >= 0 ? constructExpr->getArg(valueArgument) : nullptr);
                         }
                         extent.insert(extent.begin(), value);
                         extentString.insert(extentString.begin(), valueString);
-                        
-                        // the first template argument is the type of the content of the container
-                        clang::QualType taQualType = tsType->getArg(0).getAsType();
 
                         if (const clang::Type* const taType = taQualType.getTypePtrOrNull())
                         {
@@ -310,23 +437,16 @@ namespace TRAFO_NAMESPACE
                                 if (const clang::CXXRecordDecl* const cxxRecordDecl = taType->getAsCXXRecordDecl())
                                 {
                                     // if it is a container, get nesting information and continue the loop execution
-                                    bool isContainerType = false;
+                                    name = cxxRecordDecl->getNameAsString();
 
-                                    for (const auto& containerName : containerNames)
+                                    if (const ContainerDescriptor* const nestedDescriptor = ContainerDescriptor::find(containerDescriptors, name))
                                     {
-                                        name = cxxRecordDecl->getNameAsString();
-
-                                        if (name == containerName)
-                                        {
-                                            isNested |= true;
-                                            ++nestingLevel;
-                                            type = taType;
-                                            isContainerType = true;                                            
-                                            break;
-                                        }
+                                        isNested |= true;
+                                        ++nestingLevel;
+                                        type = taType;
+                                        descriptor = nestedDescriptor;
+                                        continue;
                                     }
-
-                                    if (isContainerType) continue;
                                 }
                             }
                         }
@@ -340,7 +460,7 @@ namespace TRAFO_NAMESPACE
                     type = nullptr;
                 }
 
-                return ContainerDeclaration(decl, isNested, nestingLevel, elementDataType, extent, extentString);
+                return ContainerDeclaration(decl, isNested, nestingLevel, elementDataType, extent, extentString, isConstantExtent);
             }
 
             virtual void printInfo(const clang::SourceManager& sourceManager, const std::string indent = std::string("")) const
@@ -368,6 +488,191 @@ namespace TRAFO_NAMESPACE
                 }
             }
         };
+
+        class HeapArrayDeclaration : public Declaration
+        {
+            using Base = Declaration;
+
+            // strip casts, temporaries and the construction of the smart pointer from the allocation
+            static const clang::Expr* getAllocationExpr(const clang::Expr* expr)
+            {
+                while (expr)
+                {
+                    const clang::Expr* const strippedExpr = expr->IgnoreImplicit()->IgnoreParenCasts();
+
+                    if (const clang::CXXConstructExpr* const constructExpr = llvm::dyn_cast<clang::CXXConstructExpr>(strippedExpr))
+                    {
+                        const clang::CXXRecordDecl* const recordDecl = constructExpr->getConstructor()->getParent();
+                        if (!recordDecl || recordDecl->getNameAsString() != std::string("unique_ptr") || constructExpr->getNumArgs() == 0) return nullptr;
+
+                        expr = constructExpr->getArg(0);
+                        continue;
+                    }
+
+                    if (strippedExpr == expr) return expr;
+
+                    expr = strippedExpr;
+                }
+
+                return nullptr;
+            }
+
+            // 'n * sizeof(T)' or 'sizeof(T) * n' -> 'n'
+            static std::string getNumElementsString(const clang::Expr* const sizeExpr, const clang::QualType& elementDataType, clang::ASTContext& context)
+            {
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+                const clang::Expr* const expr = sizeExpr->IgnoreParenImpCasts();
+
+                if (const clang::BinaryOperator* const binaryOperator = llvm::dyn_cast<clang::BinaryOperator>(expr))
+                {
+                    if (binaryOperator->getOpcode() == clang::BO_Mul)
+                    {
+                        for (std::size_t i = 0; i < 2; ++i)
+                        {
+                            const clang::Expr* const factor = (i == 0 ? binaryOperator->getRHS() : binaryOperator->getLHS());
+                            const clang::Expr* const otherFactor = (i == 0 ? binaryOperator->getLHS() : binaryOperator->getRHS());
+                            const clang::UnaryExprOrTypeTraitExpr* const sizeOfExpr = llvm::dyn_cast<clang::UnaryExprOrTypeTraitExpr>(factor->IgnoreParenImpCasts());
+
+                            if (sizeOfExpr && sizeOfExpr->getKind() == clang::UETT_SizeOf && context.hasSameUnqualifiedType(sizeOfExpr->getTypeOfArgument(), elementDataType))
+                            {
+                                return dumpTokenRangeToString(otherFactor->getSourceRange(), sourceManager);
+                            }
+                        }
+                    }
+                }
+
+                return std::string("(") + dumpTokenRangeToString(sizeExpr->getSourceRange(), sourceManager) + std::string(") / sizeof(") + elementDataType.getAsString() + std::string(")");
+            }
+
+        public:
+
+            using Base::decl;
+            using Base::sourceRange;
+            using Base::elementDataType;
+            using Base::elementDataTypeName;
+            using Base::elementDataTypeNamespace;
+
+            // how the memory was allocated: 'new', 'make_unique', 'malloc' or 'calloc'
+            const std::string allocation;
+            // the allocation initializes the elements: 'calloc' (zero), 'make_unique' and 'new T[n]()' (value initialization), 'new T[n]' of non-trivial types (default constructor)
+            const bool isInitializingAllocation;
+            // 'new T[n]{a, b, c}': the elements have values of their own
+            const bool hasElementInitializers;
+            const std::vector<std::size_t> extent;
+            const std::vector<std::string> extentString;
+
+            HeapArrayDeclaration(const clang::DeclaratorDecl& decl, const clang::QualType elementDataType, const std::string& allocation, const bool isInitializingAllocation, const bool hasElementInitializers, const std::string& extentString)
+                :
+                Base(decl, elementDataType),
+                allocation(allocation),
+                isInitializingAllocation(isInitializingAllocation),
+                hasElementInitializers(hasElementInitializers),
+                extent(1, 1), // the extent is known at runtime only
+                extentString(1, extentString)
+            { ; }
+
+            ~HeapArrayDeclaration() { ; }
+
+            bool isScalarTypeDeclaration() const { return true; }
+
+            bool isHeapArrayDeclaration() const { return true; }
+
+            std::uint32_t getNestingLevel() const { return 0; }
+
+            const std::vector<std::size_t>& getExtent() const { return extent; }
+
+            const std::vector<std::string>& getExtentString() const { return extentString; }
+
+            bool hasConstantExtent() const { return false; }
+
+            bool isSmartPointer() const { return (decl.getType()->getAsCXXRecordDecl() != nullptr); }
+
+            // T* p = new T[n], T* p = static_cast<T*>(malloc(n * sizeof(T))), std::unique_ptr<T[]> p(new T[n]), auto p = std::make_unique<T[]>(n)
+            // the element data type is null if the declaration is none of these
+            static HeapArrayDeclaration make(const clang::VarDecl& decl, clang::ASTContext& context)
+            {
+                const clang::SourceManager& sourceManager = context.getSourceManager();
+                clang::QualType elementDataType;
+                std::string allocation("");
+                bool isInitializingAllocation = false;
+                bool hasElementInitializers = false;
+                std::string extentString("");
+
+                // the declared element type
+                clang::QualType declaredElementDataType;
+                if (const clang::PointerType* const pointerType = decl.getType()->getAs<clang::PointerType>())
+                {
+                    declaredElementDataType = pointerType->getPointeeType();
+                }
+                else if (const clang::ClassTemplateSpecializationDecl* const smartPointerDecl = llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(decl.getType()->getAsCXXRecordDecl()))
+                {
+                    if (smartPointerDecl->getNameAsString() == std::string("unique_ptr") && smartPointerDecl->getTemplateArgs().size() > 0)
+                    {
+                        const clang::ArrayType* const arrayType = context.getAsArrayType(smartPointerDecl->getTemplateArgs().get(0).getAsType());
+                        if (arrayType && llvm::isa<clang::IncompleteArrayType>(arrayType))
+                        {
+                            declaredElementDataType = arrayType->getElementType();
+                        }
+                    }
+                }
+
+                const clang::Expr* const allocationExpr = (!declaredElementDataType.isNull() && decl.hasInit() ? getAllocationExpr(decl.getInit()) : nullptr);
+
+                if (const clang::CXXNewExpr* const newExpr = llvm::dyn_cast_or_null<clang::CXXNewExpr>(allocationExpr))
+                {
+                    if (newExpr->isArray() && newExpr->getArraySize())
+                    {
+                        allocation = std::string("new");
+                        isInitializingAllocation = newExpr->hasInitializer();
+                        const clang::InitListExpr* const initListExpr = llvm::dyn_cast_or_null<clang::InitListExpr>(newExpr->getInitializer());
+                        hasElementInitializers = (initListExpr && initListExpr->getNumInits() > 0);
+                        extentString = dumpTokenRangeToString(newExpr->getArraySize()->getSourceRange(), sourceManager);
+                    }
+                }
+                else if (const clang::CallExpr* const callExpr = llvm::dyn_cast_or_null<clang::CallExpr>(allocationExpr))
+                {
+                    const clang::FunctionDecl* const callee = callExpr->getDirectCallee();
+                    const std::string calleeName = (callee ? callee->getNameAsString() : std::string(""));
+
+                    if (calleeName == std::string("make_unique") && callExpr->getNumArgs() == 1)
+                    {
+                        allocation = calleeName;
+                        isInitializingAllocation = true;
+                        extentString = dumpTokenRangeToString(callExpr->getArg(0)->getSourceRange(), sourceManager);
+                    }
+                    else if (calleeName == std::string("malloc") && callExpr->getNumArgs() == 1)
+                    {
+                        allocation = calleeName;
+                        extentString = getNumElementsString(callExpr->getArg(0), declaredElementDataType, context);
+                    }
+                    else if (calleeName == std::string("calloc") && callExpr->getNumArgs() == 2)
+                    {
+                        allocation = calleeName;
+                        isInitializingAllocation = true;
+                        extentString = dumpTokenRangeToString(callExpr->getArg(0)->getSourceRange(), sourceManager);
+                    }
+                }
+
+                if (allocation.length() && extentString.length())
+                {
+                    elementDataType = declaredElementDataType.getUnqualifiedType();
+                }
+
+                return HeapArrayDeclaration(decl, elementDataType, allocation, isInitializingAllocation, hasElementInitializers, extentString);
+            }
+
+            virtual void printInfo(const clang::SourceManager& sourceManager, const std::string indent = std::string("")) const
+            {
+                std::cout << indent << "HEAP ARRAY DECLARATION" << std::endl;
+
+                Base::printInfo(sourceManager, indent + std::string("\t"));
+
+                std::cout << indent << "\t* type: " << decl.getType().getAsString() << std::endl;
+                std::cout << indent << "\t\t+-> declaration: " << decl.getSourceRange().printToString(sourceManager) << std::endl;
+                std::cout << indent << "\t\t+-> allocation: " << allocation << (isInitializingAllocation ? (hasElementInitializers ? " (element initializers)" : " (initializing)") : "") << std::endl;
+                std::cout << indent << "\t\t+-> extent: [" << extentString[0] << "]" << std::endl;
+            }
+        };
     }
 }
 
@@ -14,5 +14,12 @@ int main(int argc, const char **argv)
     OptionCategory optionCategory("proxy_gen");
 	CommonOptionsParser parser(argc, argv, optionCategory);
 	ClangTool clangTool(parser.getCompilations(), parser.getSourcePathList());
+
+	// the layouts of element types shared by several translation units depend on the field accesses in all of them
+	if (InsertProxyClassImplementation::requiresFieldAccessAnalysis() && clangTool.run(newFrontendActionFactory<AnalyzeFieldAccess>().get()) == 0)
+	{
+		InsertProxyClassImplementation::completeFieldAccessAnalysis();
+	}
+
 	return clangTool.run(newFrontendActionFactory<InsertProxyClass>().get());
 }